@@ -0,0 +1,3 @@
+#!/bin/sh
+# Runs the headless dedicated server built from the TantrumnServer target, extra arguments are passed through
+"$(dirname "$0")/Binaries/Linux/TantrumnServer" /Game/Tantrumn/Maps/Playground_AIBattle -log -port=7777 "$@"
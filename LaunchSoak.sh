@@ -0,0 +1,30 @@
+#!/bin/sh
+# Headless bot soak on Playground_AIBattle, writes json results and exits. Usage: LaunchSoak.sh [bots] [rounds] [output.json], extra arguments are passed through to the server
+# a headless spectator client joins over loopback so the bandwidth figures come from a real connection, set SOAK_CLIENTS=0 to run the server alone
+BOTS=${1:-16}
+ROUNDS=${2:-5}
+OUTPUT=${3:-"$(pwd)/TantrumnSoak.json"}
+CLIENTS=${SOAK_CLIENTS:-1}
+PORT=${SOAK_PORT:-7777}
+[ $# -gt 0 ] && shift
+[ $# -gt 0 ] && shift
+[ $# -gt 0 ] && shift
+BINARY="$(dirname "$0")/Binaries/Linux/Tantrumn"
+
+"$BINARY" "/Game/Tantrumn/Maps/Playground_AIBattle?listen?SpectatorOnly=1" -port="$PORT" -nullrhi -nosound -unattended -log -TantrumnSoak -SoakBots="$BOTS" -SoakRounds="$ROUNDS" -SoakClients="$CLIENTS" -SoakOutput="$OUTPUT" "$@" &
+SERVER_PID=$!
+
+# a client that cannot reach the server gives up instead of retrying, let the map load first
+sleep "${SOAK_CLIENT_DELAY:-10}"
+CLIENT_PIDS=""
+i=0
+while [ "$i" -lt "$CLIENTS" ]; do
+	"$BINARY" "127.0.0.1:$PORT?SpectatorOnly=1" -nullrhi -nosound -unattended -log="SoakClient$i.log" &
+	CLIENT_PIDS="$CLIENT_PIDS $!"
+	i=$((i + 1))
+done
+
+wait "$SERVER_PID"
+STATUS=$?
+[ -n "$CLIENT_PIDS" ] && kill $CLIENT_PIDS 2>/dev/null
+exit "$STATUS"
@@ -10,5 +10,8 @@ public class TantrumnTarget : TargetRules
 		Type = TargetType.Game;
 		DefaultBuildSettings = BuildSettingsVersion.V2;
 		ExtraModuleNames.AddRange( new string[] { "Tantrumn" } );
+
+		// bWithPushModel needs a unique build environment, so this shared target builds without it
+		// and the push-model dirty marks are no-ops here; only the server target compiles it in
 	}
 }
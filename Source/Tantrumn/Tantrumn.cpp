@@ -3,4 +3,8 @@
 #include "Tantrumn.h"
 #include "Modules/ModuleManager.h"
 
+CSV_DEFINE_CATEGORY(Tantrumn, true);
+
+DEFINE_LOG_CATEGORY(LogTantrumnGameState);
+
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, Tantrumn, "Tantrumn" );
@@ -3,4 +3,23 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
 
+DECLARE_STATS_GROUP(TEXT("Tantrumn"), STATGROUP_Tantrumn, STATCAT_Advanced);
+
+// gameplay phase markers and timings in csv profiler captures
+CSV_DECLARE_CATEGORY_EXTERN(Tantrumn);
+
+// match and game state changes, shared by the game mode and the matches it runs
+DECLARE_LOG_CATEGORY_EXTERN(LogTantrumnGameState, Log, All);
+
+// times a scope for stat Tantrumn, which also names it in Unreal Insights cpu traces. builds without
+// stats still get the trace scope
+#if STATS
+#define TANTRUMN_SCOPE_CYCLE_COUNTER(Stat) \
+	SCOPE_CYCLE_COUNTER(Stat)
+#else
+#define TANTRUMN_SCOPE_CYCLE_COUNTER(Stat) \
+	TRACE_CPUPROFILER_EVENT_SCOPE(Stat)
+#endif
@@ -3,6 +3,7 @@
 
 #include "TantrumnAIController.h"
 #include "TantrumnCharacterBase.h"
+#include "TantrumnGameModeBase.h"
 #include "TantrumnPlayerState.h"
 
 void ATantrumnAIController::OnPossess(APawn* InPawn) {
@@ -11,6 +12,9 @@ void ATantrumnAIController::OnPossess(APawn* InPawn) {
 		if (ATantrumnPlayerState* TantrumnPlayerState = GetPlayerState<ATantrumnPlayerState>()) {
 			TantrumnPlayerState->SetCurrentState(EPlayerGameState::Waiting);
 		}
+		if (ATantrumnGameModeBase* TantrumnGameMode = GetWorld()->GetAuthGameMode<ATantrumnGameModeBase>()) {
+			TantrumnGameMode->AssignToMatch(this);
+		}
 	}
 }
 
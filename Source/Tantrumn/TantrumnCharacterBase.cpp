@@ -2,26 +2,42 @@
 
 
 #include "TantrumnCharacterBase.h"
+#include "Tantrumn.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/GameStateBase.h"
 #include "Kismet/GameplayStatics.h"
 #include "TantrumnPlayerController.h"
 #include "ThrowableActor.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 #include "TantrumnGameInstance.h"
+#include "TantrumnLagCompensationComponent.h"
 #include "TantrumnPlayerState.h"
+#include "TantrumnRoundProfilerSubsystem.h"
+#include "TantrumnStatusEffectComponent.h"
+#include "TantrumnThrowMetricsSubsystem.h"
+#include "TantrumnTickManagerSubsystem.h"
+#include "TantrumnThrowablePoolSubsystem.h"
+#include "TantrumnThrowableSubsystem.h"
+#include "TantrumnTraceSchedulerSubsystem.h"
+#include "Animation/AnimMontage.h"
 #include "DrawDebugHelpers.h"
 #include "VisualLogger/VisualLogger.h"
 
 constexpr int CVSphereCastPlayerView = 0;
 constexpr int CVSphereCastActorTransform = 1;
 constexpr int CVLineCastActorTransform = 2;
+constexpr int CVAsyncSphereCastPlayerView = 3;
+constexpr int CVAsyncLineCastActorTransform = 4;
 
 static TAutoConsoleVariable<int> CVarTraceMode(
 	TEXT("Tantrumn.Character.Debug.TraceMode"),
 	0,
 	TEXT("  0: Sphere cast PlayerView used for direction/rotation \n")
 	TEXT("  1: Sphere cast using ActorTransform \n")
-	TEXT("  2: Line cast using ActorTransform \n"),
+	TEXT("  2: Line cast using ActorTransform \n")
+	TEXT("  3: Async sphere cast PlayerView, result handled next frame \n")
+	TEXT("  4: Async line cast using ActorTransform, result handled next frame \n"),
 	ECVF_Default
 );
 
@@ -39,15 +55,46 @@ static TAutoConsoleVariable<bool> CVarDisplayThrowVelocity(
 	ECVF_Default
 );
 
+static TAutoConsoleVariable<bool> CVarUseThrowableIndex(
+	TEXT("Tantrumn.Character.UseThrowableIndex"),
+	true,
+	TEXT("Only run pickup traces when the idle throwable index finds a candidate"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarMaxRewindTime(
+	TEXT("Tantrumn.Net.MaxRewindTime"),
+	0.4f,
+	TEXT("Maximum time in seconds targets are rewound when validating throwable hits, 0 disables lag compensation"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int> CVarActionPacketRedundancy(
+	TEXT("Tantrumn.Net.ActionPacketRedundancy"),
+	3,
+	TEXT("Number of extra frames an unreliable action packet is resent after it changes"),
+	ECVF_Default
+);
+
 DEFINE_LOG_CATEGORY_STATIC(LogTantrumnChar,Verbose, Verbose)
 
+DECLARE_CYCLE_STAT(TEXT("Pickup Trace"), STAT_TantrumnPickupTrace, STATGROUP_Tantrumn);
+DECLARE_CYCLE_STAT(TEXT("Process Trace Result"), STAT_TantrumnProcessTraceResult, STATGROUP_Tantrumn);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Character RPCs Sent"), STAT_TantrumnCharacterRPCsSent, STATGROUP_Tantrumn);
+
 // Sets default values
 ATantrumnCharacterBase::ATantrumnCharacterBase()
 {
  	// Set this character to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
+	// the tick manager enables tick once it knows the character needs it
+	PrimaryActorTick.bStartWithTickEnabled = false;
+	// skip animation updates based on screen size, the tick manager also throttles unseen remote meshes
+	GetMesh()->bEnableUpdateRateOptimizations = true;
 	bReplicates = true;
 	SetReplicateMovement(true);
+	LagCompensationComponent = CreateDefaultSubobject<UTantrumnLagCompensationComponent>(TEXT("LagCompensationComponent"));
+	StatusEffectComponent = CreateDefaultSubobject<UTantrumnStatusEffectComponent>(TEXT("StatusEffectComponent"));
 }
 
 void ATantrumnCharacterBase::GetLifetimeReplicatedProps(TArray< FLifetimeProperty >& OutLifetimeProps) const {
@@ -59,49 +106,234 @@ void ATantrumnCharacterBase::GetLifetimeReplicatedProps(TArray< FLifetimePropert
 
 	DOREPLIFETIME_WITH_PARAMS_FAST(ATantrumnCharacterBase, CharacterThrowState, SharedParams);
 
+	SharedParams.Condition = COND_OwnerOnly;
+	DOREPLIFETIME_WITH_PARAMS_FAST(ATantrumnCharacterBase, ThrowStateAck, SharedParams);
+
 	SharedParams.Condition = COND_None;
 	DOREPLIFETIME_WITH_PARAMS_FAST(ATantrumnCharacterBase, LastGroundPosition, SharedParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ATantrumnCharacterBase, StunEndTime, SharedParams);
 
 	//DOREPLIFETIME(ATantrumnCharacterBase, CharacterThrowState);
 }
 
+void ATantrumnCharacterBase::SetCharacterThrowState(ECharacterThrowState InCharacterThrowState) {
+	if (CharacterThrowState != InCharacterThrowState) {
+		const ECharacterThrowState OldCharacterThrowState = CharacterThrowState;
+		CharacterThrowState = InCharacterThrowState;
+		MARK_PROPERTY_DIRTY_FROM_NAME(ATantrumnCharacterBase, CharacterThrowState, this);
+		UpdateThrowStateTiming(OldCharacterThrowState);
+	}
+
+	// the owner skips CharacterThrowState, server side changes reach it through the ack
+	if (HasAuthority() && ThrowStateAck.State != CharacterThrowState) {
+		ThrowStateAck.State = CharacterThrowState;
+		MARK_PROPERTY_DIRTY_FROM_NAME(ATantrumnCharacterBase, ThrowStateAck, this);
+	}
+}
+
+uint8 ATantrumnCharacterBase::PredictThrowState(ECharacterThrowState InCharacterThrowState) {
+	SetCharacterThrowState(InCharacterThrowState);
+	if (HasAuthority()) {
+		// nothing to predict, the server RPC runs immediately
+		return ThrowStateAck.Sequence;
+	}
+
+	// 0 is reserved for action packets without a throw request
+	if (++LocalThrowStateSequence == 0) {
+		++LocalThrowStateSequence;
+	}
+	if (PendingThrowStates.Num() >= MaxPendingThrowStates) {
+		PendingThrowStates.RemoveAt(0, 1, false);
+	}
+	PendingThrowStates.Add({ LocalThrowStateSequence, InCharacterThrowState });
+	if (InCharacterThrowState == ECharacterThrowState::Throwing) {
+		ThrowPredictSequence = LocalThrowStateSequence;
+		ThrowPredictTime = GetWorld()->GetRealTimeSeconds();
+	}
+	return LocalThrowStateSequence;
+}
+
+void ATantrumnCharacterBase::UpdateThrowStateTiming(ECharacterThrowState OldCharacterThrowState) {
+	UTantrumnThrowMetricsSubsystem* ThrowMetrics = GetWorld()->GetSubsystem<UTantrumnThrowMetricsSubsystem>();
+	const float Now = GetWorld()->GetRealTimeSeconds();
+
+	if (CharacterThrowState == ECharacterThrowState::Pulling) {
+		PullStartTime = Now;
+	}
+	else if (CharacterThrowState == ECharacterThrowState::Attached && PullStartTime >= 0.0f && ThrowMetrics) {
+		ThrowMetrics->RecordAttachTime(this, Now - PullStartTime);
+		PullStartTime = -1.0f;
+	}
+	else if (CharacterThrowState == ECharacterThrowState::None) {
+		PullStartTime = -1.0f;
+	}
+
+	// requesting a pull can last as long as the button is held, pulling and throwing always finish on their own
+	const float StuckStateTimeout = UTantrumnThrowMetricsSubsystem::GetStuckStateTimeout();
+	if (StuckStateTimeout > 0.0f && (CharacterThrowState == ECharacterThrowState::Pulling || CharacterThrowState == ECharacterThrowState::Throwing)) {
+		GetWorldTimerManager().SetTimer(StuckThrowStateTimerHandle, this, &ATantrumnCharacterBase::OnThrowStateStuck, StuckStateTimeout, false);
+	}
+	else {
+		GetWorldTimerManager().ClearTimer(StuckThrowStateTimerHandle);
+	}
+}
+
+void ATantrumnCharacterBase::OnThrowStateStuck() {
+	if (UTantrumnThrowMetricsSubsystem* ThrowMetrics = GetWorld()->GetSubsystem<UTantrumnThrowMetricsSubsystem>()) {
+		ThrowMetrics->RecordStuckState(this, UEnum::GetDisplayValueAsText(CharacterThrowState).ToString(), UTantrumnThrowMetricsSubsystem::GetStuckStateTimeout());
+	}
+}
+
+void ATantrumnCharacterBase::AckThrowState(uint8 Sequence) {
+	// reliable requests and unreliable action packets can arrive out of order, never move the ack backwards
+	if ((int8)(Sequence - ThrowStateAck.Sequence) > 0) {
+		ThrowStateAck.Sequence = Sequence;
+	}
+	ThrowStateAck.State = CharacterThrowState;
+	MARK_PROPERTY_DIRTY_FROM_NAME(ATantrumnCharacterBase, ThrowStateAck, this);
+}
+
+void ATantrumnCharacterBase::OnRep_ThrowStateAck() {
+	// sequences wrap, anything at or behind the ack has been processed by the server
+	PendingThrowStates.RemoveAll([this](const FPendingThrowState& PendingThrowState) {
+		return (int8)(PendingThrowState.Sequence - ThrowStateAck.Sequence) <= 0;
+	});
+
+	if (ThrowPredictTime >= 0.0f && (int8)(ThrowPredictSequence - ThrowStateAck.Sequence) <= 0) {
+		if (UTantrumnThrowMetricsSubsystem* ThrowMetrics = GetWorld()->GetSubsystem<UTantrumnThrowMetricsSubsystem>()) {
+			ThrowMetrics->RecordThrowLatency(this, GetWorld()->GetRealTimeSeconds() - ThrowPredictTime);
+		}
+		ThrowPredictTime = -1.0f;
+	}
+
+	// still waiting on newer requests, their acks will carry the final server state
+	if (PendingThrowStates.Num() > 0 || CharacterThrowState == ThrowStateAck.State) {
+		return;
+	}
+
+	UE_LOG(LogTantrumnChar, Verbose, TEXT("Throw state mispredicted, predicted %s server %s"), *UEnum::GetDisplayValueAsText(CharacterThrowState).ToString(), *UEnum::GetDisplayValueAsText(ThrowStateAck.State).ToString());
+	RollbackThrowState(ThrowStateAck.State);
+}
+
+void ATantrumnCharacterBase::RollbackThrowState(ECharacterThrowState InCharacterThrowState) {
+	const ECharacterThrowState PredictedState = CharacterThrowState;
+	SetCharacterThrowState(InCharacterThrowState);
+
+	if (PredictedState == ECharacterThrowState::Throwing && ThrowMontage) {
+		StopAnimMontage(ThrowMontage);
+	}
+
+	if (InCharacterThrowState == ECharacterThrowState::None || InCharacterThrowState == ECharacterThrowState::RequestingPull) {
+		if (ThrowableActor) {
+			ThrowableActor->ToggleHighlight(false);
+			ThrowableActor = nullptr;
+		}
+	}
+}
+
+void ATantrumnCharacterBase::SetLastGroundPosition(const FVector& InLastGroundPosition) {
+	if (!LastGroundPosition.Equals(InLastGroundPosition)) {
+		LastGroundPosition = InLastGroundPosition;
+		MARK_PROPERTY_DIRTY_FROM_NAME(ATantrumnCharacterBase, LastGroundPosition, this);
+	}
+}
+
 // Called when the game starts or when spawned
 void ATantrumnCharacterBase::BeginPlay()
 {
 	Super::BeginPlay();
-	EffectCooldown = DefaultEffectCooldown;
-	if (GetCharacterMovement()) {
-		MaxWalkSpeed = GetCharacterMovement()->MaxWalkSpeed;
+	// effects modify these through the attribute set, the configured values are the base
+	StatusEffectComponent->SetBaseAttributeValue(ETantrumnAttribute::WalkSpeed, GetCharacterMovement()->MaxWalkSpeed);
+	StatusEffectComponent->SetBaseAttributeValue(ETantrumnAttribute::SprintSpeed, SprintSpeed);
+	StatusEffectComponent->SetBaseAttributeValue(ETantrumnAttribute::JumpZVelocity, GetCharacterMovement()->JumpZVelocity);
+	StatusEffectComponent->SetBaseAttributeValue(ETantrumnAttribute::ThrowSpeed, ThrowSpeed);
+	StatusEffectComponent->OnAttributeChanged.AddUObject(this, &ATantrumnCharacterBase::OnAttributeChanged);
+	BuildThrowPlayRateSteps();
+	BindMontageEvents();
+	RPCsSentStatName = FName(*FString::Printf(TEXT("RPCsSent_%s"), *GetName()));
+
+	if (UTantrumnTickManagerSubsystem* TickManager = GetWorld()->GetSubsystem<UTantrumnTickManagerSubsystem>()) {
+		TickManager->RegisterCharacter(this);
 	}
-	
 }
 
-// Called every frame
-void ATantrumnCharacterBase::Tick(float DeltaTime)
-{
-	Super::Tick(DeltaTime);
+void ATantrumnCharacterBase::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+	if (UTantrumnTraceSchedulerSubsystem* TraceScheduler = GetWorld()->GetSubsystem<UTantrumnTraceSchedulerSubsystem>()) {
+		TraceScheduler->UnregisterCharacter(this);
+	}
+	if (UTantrumnTickManagerSubsystem* TickManager = GetWorld()->GetSubsystem<UTantrumnTickManagerSubsystem>()) {
+		TickManager->UnregisterCharacter(this);
+	}
+	Super::EndPlay(EndPlayReason);
+}
 
-	if (CharacterThrowState == ECharacterThrowState::Throwing) {
-		UpdateThrowMontagePlayRate();
-		return;
+void ATantrumnCharacterBase::CountRPCSent() {
+	INC_DWORD_STAT(STAT_TantrumnCharacterRPCsSent);
+#if CSV_PROFILER
+	if (FCsvProfiler::Get()->IsCapturing()) {
+		FCsvProfiler::RecordCustomStat(RPCsSentStatName, CSV_CATEGORY_INDEX(Tantrumn), 1, ECsvCustomStatOp::Accumulate);
 	}
+#endif
+}
 
-	if (!IsLocallyControlled()) {
+bool ATantrumnCharacterBase::NeedsTick() const {
+	// a local player resends action packets and runs pickup traces, the throw play rate is timer driven
+	return IsLocallyControlled() && IsPlayerControlled();
+}
+
+void ATantrumnCharacterBase::RefreshTick() {
+	if (!HasActorBegunPlay()) {
 		return;
 	}
+	if (UTantrumnTickManagerSubsystem* TickManager = GetWorld()->GetSubsystem<UTantrumnTickManagerSubsystem>()) {
+		TickManager->RefreshCharacterTick(this);
+	}
+}
 
-	if (bIsStunned) {
-		UpdateStun(DeltaTime);
-		return;
+void ATantrumnCharacterBase::PossessedBy(AController* NewController) {
+	Super::PossessedBy(NewController);
+	RefreshTick();
+}
+
+void ATantrumnCharacterBase::UnPossessed() {
+	Super::UnPossessed();
+	RefreshTick();
+}
+
+void ATantrumnCharacterBase::OnRep_Controller() {
+	Super::OnRep_Controller();
+	RefreshTick();
+}
+
+void ATantrumnCharacterBase::OnRep_PlayerState() {
+	Super::OnRep_PlayerState();
+	RefreshTick();
+}
+
+// Called every frame
+void ATantrumnCharacterBase::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (RedundantActionSends > 0) {
+		FlushActionPacket();
 	}
 
-	if (bIsUnderEffect) {
-		UpdateEffect(DeltaTime);
+	// bots pull through AttemptPullObjectAtLocation, only local players need the highlight traces
+	if (!IsLocallyControlled() || !IsPlayerControlled()) {
 		return;
 	}
 
-	//check that player can pick up objects
-	if (CharacterThrowState == ECharacterThrowState::None || CharacterThrowState == ECharacterThrowState::RequestingPull) {
+	//check that player can pick up objects, highlighting is pointless without a local viewer
+	if (GetNetMode() != NM_DedicatedServer && !bIsStunned && (CharacterThrowState == ECharacterThrowState::None || CharacterThrowState == ECharacterThrowState::RequestingPull)) {
+		if (UTantrumnTraceSchedulerSubsystem* TraceScheduler = GetWorld()->GetSubsystem<UTantrumnTraceSchedulerSubsystem>()) {
+			const bool bLowPriority = bIsSprinting || CharacterThrowState != ECharacterThrowState::RequestingPull;
+			if (!TraceScheduler->TryConsumeTraceSlot(this, bLowPriority)) {
+				return;
+			}
+		}
+
+		TANTRUMN_SCOPE_CYCLE_COUNTER(STAT_TantrumnPickupTrace);
 		switch (CVarTraceMode->GetInt()) {
 			case CVSphereCastPlayerView:
 				SphereCastPlayerView();
@@ -112,6 +344,12 @@ void ATantrumnCharacterBase::Tick(float DeltaTime)
 			case CVLineCastActorTransform:
 				LineCastActorTransform();
 				break;
+			case CVAsyncSphereCastPlayerView:
+				AsyncSphereCastPlayerView();
+				break;
+			case CVAsyncLineCastActorTransform:
+				AsyncLineCastActorTransform();
+				break;
 			default:
 				SphereCastPlayerView();
 				break;
@@ -129,6 +367,10 @@ void ATantrumnCharacterBase::SetupPlayerInputComponent(UInputComponent* PlayerIn
 void ATantrumnCharacterBase::Landed(const FHitResult& Hit) {
 	Super::Landed(Hit);
 
+	if (HasAuthority()) {
+		SetLastGroundPosition(GetActorLocation());
+	}
+
 	ATantrumnPlayerController* TantrumnPlayerController = GetController<ATantrumnPlayerController>();
 	if (TantrumnPlayerController) {
 		const float FallImpactSpeed = FMath::Abs(GetVelocity().Z);
@@ -149,62 +391,154 @@ void ATantrumnCharacterBase::Landed(const FHitResult& Hit) {
 
 void ATantrumnCharacterBase::RequestSprintStart() {
 	if (!bIsStunned) {
-		GetCharacterMovement()->MaxWalkSpeed = SprintSpeed;
-		ServerSprintStart();
+		bIsSprinting = true;
+		GetCharacterMovement()->MaxWalkSpeed = GetSprintOrWalkSpeed();
+		SendActionPacket();
 	}
 }
 
 void ATantrumnCharacterBase::RequestSprintEnd() {
-	GetCharacterMovement()->MaxWalkSpeed = MaxWalkSpeed;
-	ServerSprintEnd();
+	bIsSprinting = false;
+	GetCharacterMovement()->MaxWalkSpeed = GetSprintOrWalkSpeed();
+	SendActionPacket();
 }
 
-void ATantrumnCharacterBase::ServerSprintStart_Implementation() {
-	GetCharacterMovement()->MaxWalkSpeed = SprintSpeed;
+void ATantrumnCharacterBase::SendActionPacket(ECharacterThrowState RequestedThrowState /* = ECharacterThrowState::None */, uint8 ThrowStateSequence /* = 0 */) {
+	// the server applies requests directly, only remote owners need to send
+	if (HasAuthority()) {
+		return;
+	}
+
+	const int32 Redundancy = FMath::Max(CVarActionPacketRedundancy->GetInt(), 0);
+
+	++ActionPacket.Sequence;
+	ActionPacket.Flags = (uint8)(bIsSprinting ? ECharacterActionFlags::Sprint : ECharacterActionFlags::None);
+	if (ThrowStateSequence != 0) {
+		ActionPacket.ThrowStateSequence = ThrowStateSequence;
+		ActionPacket.RequestedThrowState = RequestedThrowState;
+		ThrowRequestSends = Redundancy + 1;
+	}
+	else if (ThrowRequestSends <= 0) {
+		// 0 tells the server there is no throw request in this packet
+		ActionPacket.ThrowStateSequence = 0;
+	}
+
+	// the packet is the full requested state, resending it a few times covers packet loss without a reliable channel
+	RedundantActionSends = Redundancy + 1;
+	FlushActionPacket();
 }
 
-void ATantrumnCharacterBase::ServerSprintEnd_Implementation() {
-	GetCharacterMovement()->MaxWalkSpeed = MaxWalkSpeed;
+void ATantrumnCharacterBase::FlushActionPacket() {
+	--RedundantActionSends;
+	--ThrowRequestSends;
+	CountRPCSent();
+	ServerUpdateActions(ActionPacket);
 }
 
-void ATantrumnCharacterBase::OnStunBegin(float StunRatio) {
-	if (bIsStunned) {
+void ATantrumnCharacterBase::ServerUpdateActions_Implementation(const FCharacterActionPacket& InActionPacket) {
+	// drop redundant copies and packets that arrive out of order
+	if ((int8)(InActionPacket.Sequence - LastReceivedActionSequence) <= 0) {
+		return;
+	}
+	LastReceivedActionSequence = InActionPacket.Sequence;
+
+	const bool bWantsSprint = EnumHasAnyFlags((ECharacterActionFlags)InActionPacket.Flags, ECharacterActionFlags::Sprint);
+	if (bWantsSprint != bIsSprinting) {
+		bIsSprinting = bWantsSprint;
+		GetCharacterMovement()->MaxWalkSpeed = GetSprintOrWalkSpeed();
+	}
+
+	// the throw request is only applied once, later copies carry the same sequence
+	if (InActionPacket.ThrowStateSequence != 0 && (int8)(InActionPacket.ThrowStateSequence - ThrowStateAck.Sequence) > 0) {
+		ApplyRequestedThrowState(InActionPacket.RequestedThrowState);
+		AckThrowState(InActionPacket.ThrowStateSequence);
+	}
+}
+
+void ATantrumnCharacterBase::ApplyRequestedThrowState(ECharacterThrowState RequestedThrowState) {
+	ECharacterThrowState ExpectedState = ECharacterThrowState::None;
+	switch (RequestedThrowState) {
+	case ECharacterThrowState::RequestingPull:
+		ExpectedState = ECharacterThrowState::None;
+		break;
+	case ECharacterThrowState::None:
+		ExpectedState = ECharacterThrowState::RequestingPull;
+		break;
+	case ECharacterThrowState::Aiming:
+		ExpectedState = ECharacterThrowState::Attached;
+		break;
+	case ECharacterThrowState::Attached:
+		ExpectedState = ECharacterThrowState::Aiming;
+		break;
+	default:
+		// every other transition is driven by its own reliable request
+		return;
+	}
+
+	if (CharacterThrowState == ExpectedState) {
+		SetCharacterThrowState(RequestedThrowState);
+	}
+}
+
+float ATantrumnCharacterBase::GetServerWorldTime() const {
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	return GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+}
+
+void ATantrumnCharacterBase::OnStunBegin(float StunRatio, float StunScale /* = 1.0f */) {
+	// the server owns durations, other machines start the stun when StunEndTime replicates
+	if (!HasAuthority() || bIsStunned) {
 		//for now just early exit, alternative option would be to add to the stun time
 		return;
 	}
 
 	const float StunDelta = MaxStunTime - MinStunTime;
-	StunTime = MinStunTime + (StunRatio * StunDelta);
-	CurrentStunTimer = 0.0f;
-	//StunBeginTimestamp = FApp::GetCurrentTime();
-	bIsStunned = true;
-	if (bIsSprinting) {
-		RequestSprintEnd();
-	}
-	ResetThrowableObject();
+	StunEndTime = GetServerWorldTime() + ((MinStunTime + (StunRatio * StunDelta)) * StunScale);
+	MARK_PROPERTY_DIRTY_FROM_NAME(ATantrumnCharacterBase, StunEndTime, this);
+	BeginStun();
 }
 
-void ATantrumnCharacterBase::UpdateStun(float DeltaTime) {
+void ATantrumnCharacterBase::BeginStun() {
+	const float RemainingStunTime = StunEndTime - GetServerWorldTime();
+	if (RemainingStunTime <= 0.0f) {
+		OnStunEnd();
+		return;
+	}
+
+	GetWorldTimerManager().SetTimer(StunTimerHandle, this, &ATantrumnCharacterBase::OnStunEnd, RemainingStunTime, false);
 	if (bIsStunned) {
-		CurrentStunTimer += DeltaTime;
-		bIsStunned = CurrentStunTimer < StunTime;
-		if (!bIsStunned) {
-			OnStunEnd();
+		return;
+	}
+
+	bIsStunned = true;
+	// simulated proxies only follow along, the server and owner drive sprint and the held throwable
+	if (HasAuthority() || IsLocallyControlled()) {
+		if (bIsSprinting) {
+			RequestSprintEnd();
 		}
+		ResetThrowableObject();
 	}
+	OnStunChanged.Broadcast(true);
 }
 
 void ATantrumnCharacterBase::OnStunEnd() {
-	CurrentStunTimer = 0.0f;
-	//StunBeginTimestamp = 0.0f;
-	StunTime = 0.0f;
+	GetWorldTimerManager().ClearTimer(StunTimerHandle);
+	if (!bIsStunned) {
+		return;
+	}
+	bIsStunned = false;
+	OnStunChanged.Broadcast(false);
+}
+
+void ATantrumnCharacterBase::OnRep_StunEndTime() {
+	BeginStun();
 }
 
 void ATantrumnCharacterBase::RequestThrowObject() {
 	if (CanThrowObject()) {
 		if (PlayThrowMontage()) {
-			CharacterThrowState = ECharacterThrowState::Throwing;
-			ServerRequestThrowObject();
+			CountRPCSent();
+			ServerRequestThrowObject(PredictThrowState(ECharacterThrowState::Throwing));
 		}
 		else {
 			ResetThrowableObject();
@@ -212,14 +546,19 @@ void ATantrumnCharacterBase::RequestThrowObject() {
 	}
 }
 
-bool ATantrumnCharacterBase::ServerRequestThrowObject_Validate() {
+bool ATantrumnCharacterBase::ServerRequestThrowObject_Validate(uint8 Sequence) {
 	// can check the state of if the throwable actor exists etc to prevent this being broadcasted
 	return true;
 }
 
-void ATantrumnCharacterBase::ServerRequestThrowObject_Implementation() {
-	// server needs to call the multicast
-	MulticastRequestThrowObject();
+void ATantrumnCharacterBase::ServerRequestThrowObject_Implementation(uint8 Sequence) {
+	// the owner predicted Throwing, if the server disagrees the ack rolls it back
+	if (IsLocallyControlled() || CanThrowObject()) {
+		// server needs to call the multicast
+		CountRPCSent();
+		MulticastRequestThrowObject();
+	}
+	AckThrowState(Sequence);
 }
 
 void ATantrumnCharacterBase::MulticastRequestThrowObject_Implementation() {
@@ -230,14 +569,13 @@ void ATantrumnCharacterBase::MulticastRequestThrowObject_Implementation() {
 
 	PlayThrowMontage();
 	// transition out of camera if coming from aiming
-	CharacterThrowState = ECharacterThrowState::Throwing;
+	SetCharacterThrowState(ECharacterThrowState::Throwing);
 }
 
 void ATantrumnCharacterBase::RequestPullObject() {
 	//make sure we are in idle
 	if (!bIsStunned && CharacterThrowState == ECharacterThrowState::None) {
-		CharacterThrowState = ECharacterThrowState::RequestingPull;
-		ServerRequestPullObject(true);
+		SendActionPacket(ECharacterThrowState::RequestingPull, PredictThrowState(ECharacterThrowState::RequestingPull));
 	}
 }
 
@@ -255,44 +593,49 @@ bool ATantrumnCharacterBase::AttemptPullObjectAtLocation(const FVector& InLocati
 		DrawDebugLine(GetWorld(), StartPos, EndPos, HitResult.bBlockingHit ? FColor::Red : FColor::White, false);
 	}
 #endif
-	CharacterThrowState = ECharacterThrowState::RequestingPull;
+	SetCharacterThrowState(ECharacterThrowState::RequestingPull);
 	ProcessTraceResult(HitResult, false);
 	if (CharacterThrowState == ECharacterThrowState::Pulling) {
 		return true;
 	}
 
-	CharacterThrowState = ECharacterThrowState::None;
+	SetCharacterThrowState(ECharacterThrowState::None);
 	return false;
 }
 
 void ATantrumnCharacterBase::RequestStopPullObject() {
 	//if pulling an object, drop it
 	if (CharacterThrowState == ECharacterThrowState::RequestingPull) {
-		CharacterThrowState = ECharacterThrowState::None;
-		ServerRequestPullObject(false);
+		SendActionPacket(ECharacterThrowState::None, PredictThrowState(ECharacterThrowState::None));
 		//ResetThrowableObject();
 	}
 }
 
-void ATantrumnCharacterBase::ServerRequestPullObject_Implementation(bool bIsPulling) {
-	CharacterThrowState = bIsPulling ? ECharacterThrowState::RequestingPull : ECharacterThrowState::None;
-}
-
-void ATantrumnCharacterBase::ServerPullObject_Implementation(AThrowableActor* InThrowableActor) {
+void ATantrumnCharacterBase::ServerPullObject_Implementation(AThrowableActor* InThrowableActor, uint8 Sequence) {
 	if (InThrowableActor && InThrowableActor->Pull(this)) {
-		CharacterThrowState = ECharacterThrowState::Pulling;
+		SetCharacterThrowState(ECharacterThrowState::Pulling);
 		ThrowableActor = InThrowableActor;
 		ThrowableActor->ToggleHighlight(false);
 	}
+	else if (IsLocallyControlled()) {
+		// the local prediction was already applied, undo it
+		SetCharacterThrowState(ECharacterThrowState::RequestingPull);
+	}
+	AckThrowState(Sequence);
 }
 
 void ATantrumnCharacterBase::ClientThrowableAttached_Implementation(AThrowableActor* InThrowableActor) {
-	CharacterThrowState = ECharacterThrowState::Attached;
+	SetCharacterThrowState(ECharacterThrowState::Attached);
 	ThrowableActor = InThrowableActor;
 	MoveIgnoreActorAdd(ThrowableActor);
 }
 
 void ATantrumnCharacterBase::ServerBeginThrow_Implementation() {
+	// the release notify can still fire on the owner after the server rejected the throw or a stun dropped the throwable
+	if (!ThrowableActor || CharacterThrowState != ECharacterThrowState::Throwing) {
+		return;
+	}
+
 	//ignore collisions or else the throwable actor hits the player capsule
 	if (ThrowableActor->GetRootComponent()) {
 		UPrimitiveComponent* RootPrimitiveComponent = Cast<UPrimitiveComponent>(ThrowableActor->GetRootComponent());
@@ -300,24 +643,35 @@ void ATantrumnCharacterBase::ServerBeginThrow_Implementation() {
 			RootPrimitiveComponent->IgnoreActorWhenMoving(this, true);
 		}
 	}
-	const FVector& Direction = GetActorForwardVector() * ThrowSpeed;
+	const FVector& Direction = GetActorForwardVector() * StatusEffectComponent->GetAttributeValue(ETantrumnAttribute::ThrowSpeed);
 	ThrowableActor->Launch(Direction);
+	if (UTantrumnRoundProfilerSubsystem* RoundProfiler = GetWorld()->GetSubsystem<UTantrumnRoundProfilerSubsystem>()) {
+		RoundProfiler->NotifyThrow();
+	}
 
+#if ENABLE_DRAW_DEBUG
 	if (CVarDisplayThrowVelocity->GetBool()) {
 		const FVector& Start = GetMesh()->GetSocketLocation(TEXT("ObjectAttach"));
 		DrawDebugLine(GetWorld(), Start, Start + Direction, FColor::Red, false, 5.0f);
 	}
+#endif
 
 	const FVector& Start = GetMesh()->GetSocketLocation(TEXT("ObjectAttach"));
 	UE_VLOG_ARROW(this, LogTantrumnChar, Verbose, Start, Start + Direction, FColor::Red, TEXT("Throw Direction"));
 }
 
-void ATantrumnCharacterBase::ServerFinishThrow_Implementation() {
-	CharacterThrowState = ECharacterThrowState::None;
-	MoveIgnoreActorRemove(ThrowableActor);
-	if (ThrowableActor->GetRootComponent()) {
-		UPrimitiveComponent* RootPrimitiveComponent = Cast<UPrimitiveComponent>(ThrowableActor->GetRootComponent());
-		if (RootPrimitiveComponent) {
+void ATantrumnCharacterBase::ServerFinishThrow_Implementation(uint8 Sequence) {
+	// a throw the server never accepted, or one a stun already ended, only needs acking so the owner rolls back
+	if (CharacterThrowState != ECharacterThrowState::Throwing) {
+		AckThrowState(Sequence);
+		return;
+	}
+
+	SetCharacterThrowState(ECharacterThrowState::None);
+	AckThrowState(Sequence);
+	if (ThrowableActor) {
+		MoveIgnoreActorRemove(ThrowableActor);
+		if (UPrimitiveComponent* RootPrimitiveComponent = Cast<UPrimitiveComponent>(ThrowableActor->GetRootComponent())) {
 			RootPrimitiveComponent->IgnoreActorWhenMoving(this, false);
 		}
 	}
@@ -328,43 +682,94 @@ void ATantrumnCharacterBase::ResetThrowableObject() {
 	if (ThrowableActor) {
 		ThrowableActor->Drop();
 	}
-	CharacterThrowState = ECharacterThrowState::None;
+	SetCharacterThrowState(ECharacterThrowState::None);
 	ThrowableActor = nullptr;
 }
 
+void ATantrumnCharacterBase::ResetForRestart(const FTransform& InTransform) {
+	ResetThrowableObject();
+	StatusEffectComponent->ClearEffects();
+	if (StunEndTime != 0.0f) {
+		StunEndTime = 0.0f;
+		MARK_PROPERTY_DIRTY_FROM_NAME(ATantrumnCharacterBase, StunEndTime, this);
+	}
+	OnStunEnd();
+	bIsSprinting = false;
+	StopAnimMontage();
+
+	TeleportTo(InTransform.GetLocation(), InTransform.Rotator());
+	if (UCharacterMovementComponent* CharacterMovement = GetCharacterMovement()) {
+		CharacterMovement->StopMovementImmediately();
+		CharacterMovement->MaxWalkSpeed = GetSprintOrWalkSpeed();
+		CharacterMovement->SetMovementMode(MOVE_Walking);
+	}
+}
+
 void ATantrumnCharacterBase::RequestAim() {
 	if (!bIsStunned && CharacterThrowState == ECharacterThrowState::Attached) {
-		CharacterThrowState = ECharacterThrowState::Aiming;
-		ServerRequestToggleAim(true);
+		SendActionPacket(ECharacterThrowState::Aiming, PredictThrowState(ECharacterThrowState::Aiming));
 	}
 }
 
 void ATantrumnCharacterBase::RequestStopAim() {
 	if (CharacterThrowState == ECharacterThrowState::Aiming) {
-		CharacterThrowState = ECharacterThrowState::Attached;
-		ServerRequestToggleAim(false);
+		SendActionPacket(ECharacterThrowState::Attached, PredictThrowState(ECharacterThrowState::Attached));
 	}
 }
 
-void ATantrumnCharacterBase::ServerRequestToggleAim_Implementation(bool IsAiming) {
-	CharacterThrowState = IsAiming ? ECharacterThrowState::Aiming : ECharacterThrowState::Attached;
+void ATantrumnCharacterBase::RequestUseObject() {
+	if (HasAuthority()) {
+		UseThrowableObject();
+		return;
+	}
+
+	// the server applies the buff and pools the throwable, both replicate back
+	CountRPCSent();
+	ServerUseObject(PredictThrowState(ECharacterThrowState::None));
+	ThrowableActor = nullptr;
 }
 
-void ATantrumnCharacterBase::RequestUseObject() {
+void ATantrumnCharacterBase::ServerUseObject_Implementation(uint8 Sequence) {
+	if (CanThrowObject()) {
+		UseThrowableObject();
+	}
+	AckThrowState(Sequence);
+}
+
+void ATantrumnCharacterBase::UseThrowableObject() {
+	if (!ThrowableActor) {
+		return;
+	}
 	ApplyEffect_Implementation(ThrowableActor->GetEffectType(), true);
-	ThrowableActor->Destroy();
+	AThrowableActor* UsedThrowable = ThrowableActor;
 	ResetThrowableObject();
+	if (UTantrumnThrowablePoolSubsystem* PoolSubsystem = GetWorld()->GetSubsystem<UTantrumnThrowablePoolSubsystem>()) {
+		PoolSubsystem->ReleaseThrowable(UsedThrowable);
+	}
 }
 
 void ATantrumnCharacterBase::OnThrowableAttached(AThrowableActor* InThrowableActor) {
-	CharacterThrowState = ECharacterThrowState::Attached;
+	SetCharacterThrowState(ECharacterThrowState::Attached);
 	ThrowableActor = InThrowableActor;
 	MoveIgnoreActorAdd(ThrowableActor);
+	CountRPCSent();
 	ClientThrowableAttached(InThrowableActor);
 }
 
 void ATantrumnCharacterBase::NotifyHitByThrowable(AThrowableActor* InThrowable) {
-	OnStunBegin(1.0f);
+	const ATantrumnCharacterBase* Thrower = InThrowable ? Cast<ATantrumnCharacterBase>(InThrowable->GetOwner()) : nullptr;
+	OnStunBegin(1.0f, Thrower ? Thrower->StatusEffectComponent->GetAttributeValue(ETantrumnAttribute::ThrowPower) : 1.0f);
+}
+
+float ATantrumnCharacterBase::GetViewRewindTime() const {
+	// remote characters are seen roughly a round trip late, locally controlled ones need no rewind
+	if (IsLocallyControlled()) {
+		return 0.0f;
+	}
+	if (const APlayerState* CharacterPlayerState = GetPlayerState()) {
+		return FMath::Clamp(CharacterPlayerState->ExactPing * 0.001f, 0.0f, CVarMaxRewindTime->GetFloat());
+	}
+	return 0.0f;
 }
 
 bool ATantrumnCharacterBase::IsHovering() const {
@@ -374,13 +779,11 @@ bool ATantrumnCharacterBase::IsHovering() const {
 	return false;
 }
 
-void ATantrumnCharacterBase::SphereCastPlayerView() {
-	FVector Location;
-	FRotator Rotation;
-	GetController()->GetPlayerViewPoint(Location, Rotation);
-	const FVector PlayerViewForward = Rotation.Vector();
-	const float AdditionalDistance = (Location - GetActorLocation()).Size();
-	FVector EndPos = Location + (PlayerViewForward * (1000.0f + AdditionalDistance));
+bool ATantrumnCharacterBase::GetPlayerViewTrace(FVector& OutStartPos, FVector& OutEndPos, FRotator& OutRotation) {
+	GetController()->GetPlayerViewPoint(OutStartPos, OutRotation);
+	const FVector PlayerViewForward = OutRotation.Vector();
+	const float AdditionalDistance = (OutStartPos - GetActorLocation()).Size();
+	OutEndPos = OutStartPos + (PlayerViewForward * (1000.0f + AdditionalDistance));
 
 	const FVector CharacterForward = GetActorForwardVector();
 	const float DotResult = FVector::DotProduct(PlayerViewForward, CharacterForward);
@@ -390,8 +793,22 @@ void ATantrumnCharacterBase::SphereCastPlayerView() {
 			ThrowableActor->ToggleHighlight(false);
 			ThrowableActor = nullptr;
 		}
+		return false;
+	}
+	return true;
+}
+
+void ATantrumnCharacterBase::SphereCastPlayerView() {
+	FVector Location;
+	FVector EndPos;
+	FRotator Rotation;
+	if (!GetPlayerViewTrace(Location, EndPos, Rotation)) {
+		return;
+	}
+
+	if (!HasPickupCandidate(Location, EndPos, 70.0f)) {
+		ProcessTraceResult(FHitResult());
 		return;
-		UE_LOG(LogTemp, Warning, TEXT("Dot Result: %f"), DotResult);
 	}
 
 	FHitResult HitResult;
@@ -415,6 +832,10 @@ void ATantrumnCharacterBase::SphereCastPlayerView() {
 void ATantrumnCharacterBase::SphereCastActorTransform() {
 	FVector StartPos = GetActorLocation();
 	FVector EndPos = StartPos + (GetActorForwardVector() * 1000.0f);
+	if (!HasPickupCandidate(StartPos, EndPos, 70.0f)) {
+		ProcessTraceResult(FHitResult());
+		return;
+	}
 
 	EDrawDebugTrace::Type DebugTrace = CVarDisplayTrace->GetBool() ? EDrawDebugTrace::ForOneFrame : EDrawDebugTrace::None;
 	FHitResult HitResult;
@@ -425,6 +846,11 @@ void ATantrumnCharacterBase::SphereCastActorTransform() {
 void ATantrumnCharacterBase::LineCastActorTransform() {
 	FVector StartPos = GetActorLocation();
 	FVector EndPos = StartPos + (GetActorForwardVector() * 1000.0f);
+	if (!HasPickupCandidate(StartPos, EndPos, 0.0f)) {
+		ProcessTraceResult(FHitResult());
+		return;
+	}
+
 	FHitResult HitResult;
 	GetWorld() ? GetWorld()->LineTraceSingleByChannel(HitResult, StartPos, EndPos, ECollisionChannel::ECC_Visibility) : false;
 #if ENABLE_DRAW_DEBUG
@@ -435,7 +861,90 @@ void ATantrumnCharacterBase::LineCastActorTransform() {
 	ProcessTraceResult(HitResult);
 }
 
+bool ATantrumnCharacterBase::HasPickupCandidate(const FVector& StartPos, const FVector& EndPos, float TraceRadius) const {
+	if (!CVarUseThrowableIndex->GetBool()) {
+		return true;
+	}
+
+	const UTantrumnThrowableSubsystem* ThrowableSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UTantrumnThrowableSubsystem>() : nullptr;
+	return !ThrowableSubsystem || ThrowableSubsystem->HasCandidateInCone(StartPos, EndPos, TraceRadius);
+}
+
+void ATantrumnCharacterBase::AsyncSphereCastPlayerView() {
+	FVector StartPos;
+	FVector EndPos;
+	FRotator Rotation;
+	if (!GetPlayerViewTrace(StartPos, EndPos, Rotation)) {
+		return;
+	}
+
+	if (!HasPickupCandidate(StartPos, EndPos, 70.0f)) {
+		ProcessTraceResult(FHitResult());
+		return;
+	}
+
+	// only keep one query in flight, the result of the previous one is still valid for highlighting
+	if (GetWorld()->IsTraceHandleValid(PendingTraceHandle, false)) {
+		return;
+	}
+
+	if (!AsyncTraceDelegate.IsBound()) {
+		AsyncTraceDelegate.BindUObject(this, &ATantrumnCharacterBase::OnAsyncTraceCompleted);
+	}
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(TantrumnPickupTrace), false, this);
+	PendingTraceHandle = GetWorld()->AsyncSweepByChannel(EAsyncTraceType::Single, StartPos, EndPos, FQuat::Identity, ECollisionChannel::ECC_Visibility, FCollisionShape::MakeSphere(70.0f), QueryParams, FCollisionResponseParams::DefaultResponseParam, &AsyncTraceDelegate);
+
+#if ENABLE_DRAW_DEBUG
+	if (CVarDisplayTrace->GetBool()) {
+		DrawDebugLine(GetWorld(), StartPos, EndPos, FColor::Yellow);
+	}
+#endif
+}
+
+void ATantrumnCharacterBase::AsyncLineCastActorTransform() {
+	FVector StartPos = GetActorLocation();
+	FVector EndPos = StartPos + (GetActorForwardVector() * 1000.0f);
+	if (!HasPickupCandidate(StartPos, EndPos, 0.0f)) {
+		ProcessTraceResult(FHitResult());
+		return;
+	}
+
+	if (GetWorld()->IsTraceHandleValid(PendingTraceHandle, false)) {
+		return;
+	}
+
+	if (!AsyncTraceDelegate.IsBound()) {
+		AsyncTraceDelegate.BindUObject(this, &ATantrumnCharacterBase::OnAsyncTraceCompleted);
+	}
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(TantrumnPickupTrace), false, this);
+	PendingTraceHandle = GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, StartPos, EndPos, ECollisionChannel::ECC_Visibility, QueryParams, FCollisionResponseParams::DefaultResponseParam, &AsyncTraceDelegate);
+
+#if ENABLE_DRAW_DEBUG
+	if (CVarDisplayTrace->GetBool()) {
+		DrawDebugLine(GetWorld(), StartPos, EndPos, FColor::Yellow, false);
+	}
+#endif
+}
+
+void ATantrumnCharacterBase::OnAsyncTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum) {
+	if (TraceHandle != PendingTraceHandle) {
+		return;
+	}
+	PendingTraceHandle = FTraceHandle();
+
+	// state may have changed during the frame the trace was in flight
+	if (!IsLocallyControlled() || bIsStunned) {
+		return;
+	}
+	if (CharacterThrowState != ECharacterThrowState::None && CharacterThrowState != ECharacterThrowState::RequestingPull) {
+		return;
+	}
+
+	ProcessTraceResult(TraceDatum.OutHits.Num() > 0 ? TraceDatum.OutHits[0] : FHitResult());
+}
+
 void ATantrumnCharacterBase::ProcessTraceResult(const FHitResult& HitResult, bool bHighlight /* = true */) {
+	TANTRUMN_SCOPE_CYCLE_COUNTER(STAT_TantrumnProcessTraceResult);
 	AThrowableActor* HitThrowableActor = HitResult.bBlockingHit ? Cast<AThrowableActor>(HitResult.GetActor()) : nullptr;
 	const bool IsSameActor = (ThrowableActor == HitThrowableActor);
 	const bool IsValidTarget = HitThrowableActor && HitThrowableActor->IsIdle();
@@ -458,9 +967,10 @@ void ATantrumnCharacterBase::ProcessTraceResult(const FHitResult& HitResult, boo
 
 	if (CharacterThrowState == ECharacterThrowState::RequestingPull) {
 		if (GetVelocity().SizeSquared() < 100.0f) {
-			ServerPullObject(ThrowableActor);
-			CharacterThrowState = ECharacterThrowState::Pulling;
-			ThrowableActor->ToggleHighlight(false);
+			AThrowableActor* PullTarget = ThrowableActor;
+			PullTarget->ToggleHighlight(false);
+			CountRPCSent();
+			ServerPullObject(PullTarget, PredictThrowState(ECharacterThrowState::Pulling));
 		}
 	}
 }
@@ -470,45 +980,19 @@ bool ATantrumnCharacterBase::PlayThrowMontage() {
 	const FName StartSectionName = IsAiming() ? TEXT("AimStart") : TEXT("Default");
 	bool bPlayedSuccessfully = PlayAnimMontage(ThrowMontage, PlayRate, StartSectionName) > 0.0f;
 	if (bPlayedSuccessfully) {
-		if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance()) {
-			if (!BlendingOutDelegate.IsBound()) {
-				BlendingOutDelegate.BindUObject(this, &ATantrumnCharacterBase::OnMontageBlendingOut);
-			}
-			AnimInstance->Montage_SetBlendingOutDelegate(BlendingOutDelegate, ThrowMontage);
-
-			if (!MontageEndedDelegate.IsBound()) {
-				MontageEndedDelegate.BindUObject(this, &ATantrumnCharacterBase::OnMontageEnded);
-			}
-			AnimInstance->Montage_SetEndDelegate(MontageEndedDelegate, ThrowMontage);
-
-			if (IsLocallyControlled()) {
-				AnimInstance->OnPlayMontageNotifyBegin.AddDynamic(this, &ATantrumnCharacterBase::OnNotifyBeginReceived);
-				AnimInstance->OnPlayMontageNotifyEnd.AddDynamic(this, &ATantrumnCharacterBase::OnNotifyEndReceived);
-			}
-		}
+		UpdateThrowMontagePlayRate();
 	}
 	return bPlayedSuccessfully;
 }
 
 bool ATantrumnCharacterBase::PlayCelebrateMontage() {
 	const float PlayRate = 1.0f;
-	bool bPlayedSuccessfully = PlayAnimMontage(CelebrateMontage, PlayRate) > 0.f;
-	if (bPlayedSuccessfully) {
-		UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
-		if (!BlendingOutDelegate.IsBound()) {
-			BlendingOutDelegate.BindUObject(this, &ATantrumnCharacterBase::OnMontageBlendingOut);
-		}
-		AnimInstance->Montage_SetBlendingOutDelegate(BlendingOutDelegate, CelebrateMontage);
-
-		if (!MontageEndedDelegate.IsBound()) {
-			MontageEndedDelegate.BindUObject(this, &ATantrumnCharacterBase::OnMontageEnded);
-		}
-		AnimInstance->Montage_SetEndDelegate(MontageEndedDelegate, CelebrateMontage);
-	}
-	return bPlayedSuccessfully;
+	bPlayingWinnerCelebration = false;
+	return PlayAnimMontage(CelebrateMontage, PlayRate) > 0.f;
 }
 
 void ATantrumnCharacterBase::ServerPlayCelebrateMontage_Implementation() {
+	CountRPCSent();
 	MulticastPlayCelebrateMontage();
 }
 
@@ -516,19 +1000,100 @@ void ATantrumnCharacterBase::MulticastPlayCelebrateMontage_Implementation() {
 	PlayCelebrateMontage();
 }
 
-void ATantrumnCharacterBase::UpdateThrowMontagePlayRate() {
-	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance()) {
-		if (UAnimMontage* CurrentAnimMontage = AnimInstance->GetCurrentActiveMontage()) {
-			const float PlayRate = AnimInstance->GetCurveValue(TEXT("ThrowCurve"));
-			AnimInstance->Montage_SetPlayRate(CurrentAnimMontage, PlayRate);
+static const FFloatCurve* FindFloatCurve(const UAnimSequenceBase* Animation, FName CurveName) {
+	for (const FFloatCurve& Curve : Animation->GetCurveData().FloatCurves) {
+		if (Curve.Name.DisplayName == CurveName) {
+			return &Curve;
 		}
 	}
+	return nullptr;
+}
+
+float ATantrumnCharacterBase::EvaluateThrowCurve(float MontagePosition) const {
+	static const FName ThrowCurveName(TEXT("ThrowCurve"));
+	if (const FFloatCurve* Curve = FindFloatCurve(ThrowMontage, ThrowCurveName)) {
+		return Curve->Evaluate(MontagePosition);
+	}
+
+	// the curve usually lives on the animation the montage plays
+	for (const FSlotAnimationTrack& SlotAnimTrack : ThrowMontage->SlotAnimTracks) {
+		const FAnimSegment* Segment = SlotAnimTrack.AnimTrack.GetSegmentAtTime(MontagePosition);
+		if (Segment && Segment->AnimReference) {
+			if (const FFloatCurve* Curve = FindFloatCurve(Segment->AnimReference, ThrowCurveName)) {
+				return Curve->Evaluate(Segment->ConvertTrackPosToAnimPos(MontagePosition));
+			}
+		}
+	}
+	return 1.0f;
+}
+
+void ATantrumnCharacterBase::BuildThrowPlayRateSteps() {
+	ThrowPlayRateSteps.Reset();
+	if (!ThrowMontage) {
+		return;
+	}
+
+	const float MontageLength = ThrowMontage->GetPlayLength();
+	const float StepLength = FMath::Max(ThrowPlayRateStepLength, 0.01f);
+	const int32 SamplesPerStep = 4;
+	const float MinPlayRate = 0.05f;
+	for (float StepStart = 0.0f; StepStart < MontageLength; StepStart += StepLength) {
+		// a constant rate that covers the step in the same real time as the curve keeps the throw notify where it was
+		const float StepEnd = FMath::Min(StepStart + StepLength, MontageLength);
+		const float SampleLength = (StepEnd - StepStart) / SamplesPerStep;
+		float StepDuration = 0.0f;
+		for (int32 Sample = 0; Sample < SamplesPerStep; ++Sample) {
+			StepDuration += SampleLength / FMath::Max(EvaluateThrowCurve(StepStart + (Sample + 0.5f) * SampleLength), MinPlayRate);
+		}
+
+		const float PlayRate = (StepEnd - StepStart) / StepDuration;
+		if (ThrowPlayRateSteps.Num() == 0 || !FMath::IsNearlyEqual(ThrowPlayRateSteps.Last().PlayRate, PlayRate, 0.01f)) {
+			ThrowPlayRateSteps.Add({ StepStart, PlayRate });
+		}
+	}
+}
+
+void ATantrumnCharacterBase::UpdateThrowMontagePlayRate() {
+	GetWorldTimerManager().ClearTimer(ThrowPlayRateTimerHandle);
+
+	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
+	if (!AnimInstance || ThrowPlayRateSteps.Num() == 0 || !AnimInstance->Montage_IsPlaying(ThrowMontage)) {
+		return;
+	}
+
+	// timers fire on frame boundaries, allow the montage to be a frame short of the next step
+	const float Position = AnimInstance->Montage_GetPosition(ThrowMontage);
+	const float PositionTolerance = 1.0f / 30.0f;
+	int32 StepIndex = ThrowPlayRateSteps.Num() - 1;
+	while (StepIndex > 0 && ThrowPlayRateSteps[StepIndex].Position > Position + PositionTolerance) {
+		--StepIndex;
+	}
+
+	const FThrowPlayRateStep& Step = ThrowPlayRateSteps[StepIndex];
+	AnimInstance->Montage_SetPlayRate(ThrowMontage, Step.PlayRate);
+	if (ThrowPlayRateSteps.IsValidIndex(StepIndex + 1)) {
+		const float TimeToNextStep = (ThrowPlayRateSteps[StepIndex + 1].Position - Position) / Step.PlayRate;
+		GetWorldTimerManager().SetTimer(ThrowPlayRateTimerHandle, this, &ATantrumnCharacterBase::UpdateThrowMontagePlayRate, FMath::Max(TimeToNextStep, KINDA_SMALL_NUMBER), false);
+	}
 }
 
-void ATantrumnCharacterBase::UnbindMontage() {
-	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance()) {
-		AnimInstance->OnPlayMontageNotifyBegin.RemoveDynamic(this, &ATantrumnCharacterBase::OnNotifyBeginReceived);
-		AnimInstance->OnPlayMontageNotifyEnd.RemoveDynamic(this, &ATantrumnCharacterBase::OnNotifyEndReceived);
+void ATantrumnCharacterBase::BindMontageEvents() {
+	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
+	if (!AnimInstance) {
+		return;
+	}
+
+	AnimInstance->OnMontageBlendingOut.AddUniqueDynamic(this, &ATantrumnCharacterBase::OnMontageBlendingOut);
+	AnimInstance->OnMontageEnded.AddUniqueDynamic(this, &ATantrumnCharacterBase::OnMontageEnded);
+	AnimInstance->OnPlayMontageNotifyBegin.AddUniqueDynamic(this, &ATantrumnCharacterBase::OnNotifyBeginReceived);
+	AnimInstance->OnPlayMontageNotifyEnd.AddUniqueDynamic(this, &ATantrumnCharacterBase::OnNotifyEndReceived);
+
+	if (ThrowMontage) {
+		MontageNotifyRoutes.FindOrAdd(ThrowMontage).Add(NAME_None, FSimpleDelegate::CreateUObject(this, &ATantrumnCharacterBase::OnThrowReleaseNotify));
+		MontageEndedRoutes.Add(ThrowMontage, FOnMontageEnded::CreateUObject(this, &ATantrumnCharacterBase::OnThrowMontageEnded));
+	}
+	if (CelebrateMontage) {
+		MontageEndedRoutes.Add(CelebrateMontage, FOnMontageEnded::CreateUObject(this, &ATantrumnCharacterBase::OnCelebrateMontageEnded));
 	}
 }
 
@@ -537,39 +1102,67 @@ void ATantrumnCharacterBase::OnMontageBlendingOut(UAnimMontage* Montage, bool bI
 }
 
 void ATantrumnCharacterBase::OnMontageEnded(UAnimMontage* Montage, bool bInterrupted) {
-	if (IsLocallyControlled()) {
-		UnbindMontage();
+	if (const FOnMontageEnded* Route = MontageEndedRoutes.Find(Montage)) {
+		Route->ExecuteIfBound(Montage, bInterrupted);
 	}
-	
-	if (Montage == ThrowMontage) {
-		if (IsLocallyControlled()) {
-			CharacterThrowState = ECharacterThrowState::None;
-			ServerFinishThrow();
-			ThrowableActor = nullptr;
-		}
+}
+
+void ATantrumnCharacterBase::OnThrowMontageEnded(UAnimMontage* Montage, bool bInterrupted) {
+	GetWorldTimerManager().ClearTimer(ThrowPlayRateTimerHandle);
+	// a rollback or stun has already left Throwing and stopped the montage, the server has nothing to finish
+	if (IsLocallyControlled() && CharacterThrowState == ECharacterThrowState::Throwing) {
+		CountRPCSent();
+		ServerFinishThrow(PredictThrowState(ECharacterThrowState::None));
+		ThrowableActor = nullptr;
 	}
-	else if (Montage == CelebrateMontage) {
-		//if (IsLocallyControlled()) {
-		//	//display hud
-		//	if (UTantrumnGameInstance* TantrumnGameInstance = GetWorld()->GetGameInstance<UTantrumnGameInstance>()) {
-		//		ATantrumnPlayerController* TantrumnPlayerController = GetController<ATantrumnPlayerController>();
-		//		if (TantrumnPlayerController) {
-		//			TantrumnGameInstance->DisplayLevelComplete(TantrumnPlayerController);
-		//		}
-		//	}
-		//}
-
-		if (ATantrumnPlayerState* TantrumnPlayerState = GetPlayerState<ATantrumnPlayerState>()) {
-			if (TantrumnPlayerState->IsWinner()) {
-				float length = PlayAnimMontage(CelebrateMontage, 1.0f, TEXT("Winner"));
-				ensureAlwaysMsgf(length > 0.f, TEXT("ATantrumnCharacterBase::OnMontageEnded Could Not Play Winner Animation"));
-			}
+}
+
+void ATantrumnCharacterBase::OnCelebrateMontageEnded(UAnimMontage* Montage, bool bInterrupted) {
+	//if (IsLocallyControlled()) {
+	//	//display hud
+	//	if (UTantrumnGameInstance* TantrumnGameInstance = GetWorld()->GetGameInstance<UTantrumnGameInstance>()) {
+	//		ATantrumnPlayerController* TantrumnPlayerController = GetController<ATantrumnPlayerController>();
+	//		if (TantrumnPlayerController) {
+	//			TantrumnGameInstance->DisplayLevelComplete(TantrumnPlayerController);
+	//		}
+	//	}
+	//}
+
+	if (bPlayingWinnerCelebration) {
+		bPlayingWinnerCelebration = false;
+		return;
+	}
+
+	if (ATantrumnPlayerState* TantrumnPlayerState = GetPlayerState<ATantrumnPlayerState>()) {
+		if (TantrumnPlayerState->IsWinner()) {
+			float length = PlayAnimMontage(CelebrateMontage, 1.0f, TEXT("Winner"));
+			ensureAlwaysMsgf(length > 0.f, TEXT("ATantrumnCharacterBase::OnMontageEnded Could Not Play Winner Animation"));
+			bPlayingWinnerCelebration = length > 0.f;
 		}
 	}
 }
 
 void ATantrumnCharacterBase::OnNotifyBeginReceived(FName NotifyName, const FBranchingPointNotifyPayload& BranchingPointNotifyPayload) {
-	ServerBeginThrow();
+	const TMap<FName, FSimpleDelegate>* Routes = MontageNotifyRoutes.Find(BranchingPointNotifyPayload.SequenceAsset);
+	if (!Routes) {
+		return;
+	}
+
+	const FSimpleDelegate* Route = Routes->Find(NotifyName);
+	if (!Route) {
+		Route = Routes->Find(NAME_None);
+	}
+	if (Route) {
+		Route->ExecuteIfBound();
+	}
+}
+
+void ATantrumnCharacterBase::OnThrowReleaseNotify() {
+	// only the owner reports the release, a rolled back throw can still be blending out
+	if (IsLocallyControlled() && CharacterThrowState == ECharacterThrowState::Throwing) {
+		CountRPCSent();
+		ServerBeginThrow();
+	}
 }
 
 void ATantrumnCharacterBase::OnNotifyEndReceived(FName NotifyName, const FBranchingPointNotifyPayload& BranchingPointNotifyPayload) {
@@ -578,45 +1171,29 @@ void ATantrumnCharacterBase::OnNotifyEndReceived(FName NotifyName, const FBranch
 
 void ATantrumnCharacterBase::OnRep_CharacterThrowState(const ECharacterThrowState& OldCharacterThrowState) {
 	if (CharacterThrowState != OldCharacterThrowState) {
-		UE_LOG(LogTemp, Warning, TEXT("OldThrowState: %s"), *UEnum::GetDisplayValueAsText(OldCharacterThrowState).ToString());
-		UE_LOG(LogTemp, Warning, TEXT("CharacterThrowState: %s"), *UEnum::GetDisplayValueAsText(CharacterThrowState).ToString());
+		UE_LOG(LogTantrumnChar, Verbose, TEXT("Throw state %s -> %s"), *UEnum::GetDisplayValueAsText(OldCharacterThrowState).ToString(), *UEnum::GetDisplayValueAsText(CharacterThrowState).ToString());
 	}
 }
 
 void ATantrumnCharacterBase::ApplyEffect_Implementation(EEffectType EffectType, bool bIsBuff) {
-	if (bIsUnderEffect) return;
-
-	CurrentEffect = EffectType;
-	bIsUnderEffect = true;
-	bIsEffectBuff = bIsBuff;
-
-	switch (CurrentEffect) {
-	case EEffectType::Speed :
-		bIsEffectBuff ? SprintSpeed *= 2 : GetCharacterMovement()->DisableMovement();
-		break;
-	default:
-		break;
-	}
+	// the server owns effects, the component replicates them to everyone else
+	StatusEffectComponent->ApplyEffect(EffectType, bIsBuff);
 }
 
-void ATantrumnCharacterBase::UpdateEffect(float DeltaTime) {
-	if (EffectCooldown > 0) {
-		EffectCooldown -= DeltaTime;
-	}
-	else {
-		bIsUnderEffect = false;
-		EffectCooldown = DefaultEffectCooldown;
-		EndEffect();
-	}
+float ATantrumnCharacterBase::GetSprintOrWalkSpeed() const {
+	return StatusEffectComponent->GetAttributeValue(bIsSprinting ? ETantrumnAttribute::SprintSpeed : ETantrumnAttribute::WalkSpeed);
 }
 
-void ATantrumnCharacterBase::EndEffect() {
-	bIsUnderEffect = false;
-	switch (CurrentEffect) {
-	case EEffectType::Speed :
-		bIsEffectBuff ? SprintSpeed /= 2, RequestSprintEnd() : GetCharacterMovement()->SetMovementMode(MOVE_Walking);
+void ATantrumnCharacterBase::OnAttributeChanged(ETantrumnAttribute Attribute, float Value) {
+	switch (Attribute) {
+	case ETantrumnAttribute::WalkSpeed:
+	case ETantrumnAttribute::SprintSpeed:
+		GetCharacterMovement()->MaxWalkSpeed = GetSprintOrWalkSpeed();
+		break;
+	case ETantrumnAttribute::JumpZVelocity:
+		GetCharacterMovement()->JumpZVelocity = Value;
 		break;
 	default:
 		break;
 	}
-}
\ No newline at end of file
+}
@@ -5,9 +5,13 @@
 #include "CoreMinimal.h"
 #include "InteractInterface.h"
 #include "GameFramework/Character.h"
+#include "WorldCollision.h"
 #include "TantrumnCharacterBase.generated.h"
 
 class AThrowableActor;
+class UTantrumnLagCompensationComponent;
+class UTantrumnStatusEffectComponent;
+enum class ETantrumnAttribute : uint8;
 
 UENUM(BlueprintType)
 enum class ECharacterThrowState : uint8 {
@@ -19,6 +23,59 @@ enum class ECharacterThrowState : uint8 {
 	Aiming			UMETA(DisplayName = "Aiming"),
 };
 
+// last client request the server processed and the throw state it resulted in
+USTRUCT()
+struct FCharacterThrowStateAck {
+	GENERATED_BODY()
+
+	UPROPERTY()
+	uint8 Sequence = 0;
+
+	UPROPERTY()
+	ECharacterThrowState State = ECharacterThrowState::None;
+};
+
+// continuous actions held by the owning client, sent every time one changes
+enum class ECharacterActionFlags : uint8 {
+	None	= 0,
+	Sprint	= 1 << 0,
+};
+ENUM_CLASS_FLAGS(ECharacterActionFlags);
+
+// compact per frame request from the owning client, sent unreliably with redundancy
+USTRUCT()
+struct FCharacterActionPacket {
+	GENERATED_BODY()
+
+	UPROPERTY()
+	uint8 Sequence = 0;
+
+	// ECharacterActionFlags
+	UPROPERTY()
+	uint8 Flags = 0;
+
+	// latest predicted pull/aim change and its throw state sequence, applied once by the server
+	UPROPERTY()
+	uint8 ThrowStateSequence = 0;
+
+	UPROPERTY()
+	ECharacterThrowState RequestedThrowState = ECharacterThrowState::None;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnStunChanged, bool, bStunned);
+
+// constant play rate used from Position until the next step, baked from the montage's ThrowCurve
+struct FThrowPlayRateStep {
+	float Position;
+	float PlayRate;
+};
+
+// throw state the owning client applied locally and is waiting on the server to acknowledge
+struct FPendingThrowState {
+	uint8 Sequence;
+	ECharacterThrowState State;
+};
+
 UCLASS()
 class TANTRUMN_API ATantrumnCharacterBase : public ACharacter, public IInteractInterface
 {
@@ -33,6 +90,15 @@ public:
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
 
+	// true while the character has per frame work, the tick manager disables tick otherwise
+	bool NeedsTick() const;
+
+	virtual void PossessedBy(AController* NewController) override;
+	virtual void UnPossessed() override;
+	virtual void OnRep_Controller() override;
+	// IsPlayerControlled needs the player state, which can arrive after the controller
+	virtual void OnRep_PlayerState() override;
+
 	// Called to bind functionality to input
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 
@@ -73,21 +139,42 @@ public:
 	UFUNCTION(BlueprintPure)
 	ECharacterThrowState GetCharacterThrowState() const { return CharacterThrowState; }
 
+	UFUNCTION(BlueprintPure)
+	const FVector& GetLastGroundPosition() const { return LastGroundPosition; }
+
+	UFUNCTION(BlueprintCallable)
+	void SetLastGroundPosition(const FVector& InLastGroundPosition);
+
 	UFUNCTION(BlueprintPure)
 	bool IsStunned() const { return bIsStunned; }
 
+	// fired on every machine when a stun starts and ends, effects report through the status effect component
+	UPROPERTY(BlueprintAssignable)
+	FOnStunChanged OnStunChanged;
+
+	UTantrumnStatusEffectComponent* GetStatusEffectComponent() const { return StatusEffectComponent; }
+
 	UFUNCTION(BlueprintCallable)
 	void NotifyHitByThrowable(AThrowableActor* InThrowable);
 
+	UTantrumnLagCompensationComponent* GetLagCompensationComponent() const { return LagCompensationComponent; }
+
+	// how far back in server time this character's view of other characters is, server only
+	float GetViewRewindTime() const;
+
 	UFUNCTION(BlueprintPure)
 	bool IsHovering() const;
 
 	UFUNCTION(Server, Reliable)
 	void ServerPlayCelebrateMontage();
 
+	// server only, clears throw, stun and effect state and moves the character back to InTransform
+	void ResetForRestart(const FTransform& InTransform);
+
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	UPROPERTY(EditAnywhere, Category = "Movement")
 	float SprintSpeed = 1200.0f;
@@ -104,14 +191,21 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "Fall Impact")
 	float MaxStunTime = 3.0f;
 
-	float StunTime = 0.0f;
-	//float StunBeginTimestamp = 0.0f;
-	float CurrentStunTimer = 0.0f;
+	// server world time the current stun ends, every copy expires the stun with its own timer
+	UPROPERTY(ReplicatedUsing = OnRep_StunEndTime)
+	float StunEndTime = 0.0f;
+
+	UFUNCTION()
+	void OnRep_StunEndTime();
+
+	FTimerHandle StunTimerHandle;
 
 	bool bIsStunned = false;
 	bool bIsSprinting = false;
 
-	float MaxWalkSpeed = 0.0f;
+	// applies the aggregated effect attributes to movement
+	void OnAttributeChanged(ETantrumnAttribute Attribute, float Value);
+	float GetSprintOrWalkSpeed() const;
 
 	bool PlayThrowMontage();
 	bool PlayCelebrateMontage();
@@ -119,18 +213,42 @@ protected:
 	UFUNCTION(NetMulticast, Reliable)
 	void MulticastPlayCelebrateMontage();
 
+	// the ThrowCurve is baked into play rate steps once per montage, throwing then only needs a timer per step
+	void BuildThrowPlayRateSteps();
+	float EvaluateThrowCurve(float MontagePosition) const;
 	void UpdateThrowMontagePlayRate();
-	void UnbindMontage();
+
+	TArray<FThrowPlayRateStep> ThrowPlayRateSteps;
+	FTimerHandle ThrowPlayRateTimerHandle;
+
+	// the anim instance events are bound once, then routed natively by montage and notify name so playing a montage binds nothing
+	void BindMontageEvents();
 
 	UFUNCTION()
 	void OnMontageBlendingOut(UAnimMontage* Montage, bool bInterrupted);
 	UFUNCTION()
 	void OnMontageEnded(UAnimMontage* Montage, bool bInterrupted);
 
-	void OnStunBegin(float StunRatio);
-	void UpdateStun(float DeltaTime);
+	void OnThrowMontageEnded(UAnimMontage* Montage, bool bInterrupted);
+	void OnCelebrateMontageEnded(UAnimMontage* Montage, bool bInterrupted);
+	void OnThrowReleaseNotify();
+
+	// NAME_None handles any notify the montage has no named handler for
+	TMap<const UAnimSequenceBase*, TMap<FName, FSimpleDelegate>> MontageNotifyRoutes;
+	TMap<const UAnimMontage*, FOnMontageEnded> MontageEndedRoutes;
+
+	// the winner section is played from the celebrate end, it must not restart itself when it ends
+	bool bPlayingWinnerCelebration = false;
+
+	// server only, starts a stun scaled between MinStunTime and MaxStunTime, StunScale comes from the thrower's power
+	void OnStunBegin(float StunRatio, float StunScale = 1.0f);
+	// applies the stun described by StunEndTime on this machine
+	void BeginStun();
 	void OnStunEnd();
 
+	// GetServerWorldTimeSeconds, the clock StunEndTime is measured in
+	float GetServerWorldTime() const;
+
 	UFUNCTION()
 	void OnNotifyBeginReceived(FName NotifyName, const FBranchingPointNotifyPayload& BranchingPointNotifyPayload);
 	UFUNCTION()
@@ -139,26 +257,35 @@ protected:
 	void SphereCastPlayerView();
 	void SphereCastActorTransform();
 	void LineCastActorTransform();
+	// returns false when the view is facing away from the character and no trace should run
+	bool GetPlayerViewTrace(FVector& OutStartPos, FVector& OutEndPos, FRotator& OutRotation);
+
+	void AsyncSphereCastPlayerView();
+	void AsyncLineCastActorTransform();
+	void OnAsyncTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
 	void ProcessTraceResult(const FHitResult& HitResult, bool bHighlight = true);
+	// cheap check against the idle throwable index so we only trace when something could be hit
+	bool HasPickupCandidate(const FVector& StartPos, const FVector& EndPos, float TraceRadius) const;
 
 	//RPC actions done on server in order to replicate
-	UFUNCTION(Server, Reliable)
-	void ServerSprintStart();
-
-	UFUNCTION(Server, Reliable)
-	void ServerSprintEnd();
+	// sprint and pull/aim toggles, reliable RPCs are kept for one shot events only
+	UFUNCTION(Server, Unreliable)
+	void ServerUpdateActions(const FCharacterActionPacket& InActionPacket);
 
-	UFUNCTION(Server, Reliable)
-	void ServerPullObject(AThrowableActor* InThrowableActor);
+	void SendActionPacket(ECharacterThrowState RequestedThrowState = ECharacterThrowState::None, uint8 ThrowStateSequence = 0);
+	void FlushActionPacket();
+	void ApplyRequestedThrowState(ECharacterThrowState RequestedThrowState);
 
-	UFUNCTION(Server, Reliable)
-	void ServerRequestPullObject(bool bIsPulling);
+	FCharacterActionPacket ActionPacket;
+	int32 RedundantActionSends = 0;
+	int32 ThrowRequestSends = 0;
+	uint8 LastReceivedActionSequence = 0;
 
 	UFUNCTION(Server, Reliable)
-	void ServerRequestToggleAim(bool IsAiming);
+	void ServerPullObject(AThrowableActor* InThrowableActor, uint8 Sequence);
 
 	UFUNCTION(Server, Reliable, WithValidation)
-	void ServerRequestThrowObject();
+	void ServerRequestThrowObject(uint8 Sequence);
 
 	UFUNCTION(NetMulticast, Reliable)
 	void MulticastRequestThrowObject();
@@ -170,25 +297,76 @@ protected:
 	void ServerBeginThrow();
 
 	UFUNCTION(Server, Reliable)
-	void ServerFinishThrow();
+	void ServerFinishThrow(uint8 Sequence);
+
+	UFUNCTION(Server, Reliable)
+	void ServerUseObject(uint8 Sequence);
+
+	// server only, consumes the held throwable for its buff
+	void UseThrowableObject();
 
 	UPROPERTY(VisibleAnywhere, ReplicatedUsing = OnRep_CharacterThrowState, Category = "Throw")
 	ECharacterThrowState CharacterThrowState = ECharacterThrowState::None;
 
+	// push model replication, always write CharacterThrowState through here so it is marked dirty
+	void SetCharacterThrowState(ECharacterThrowState InCharacterThrowState);
+
+	// asks the tick manager to re-evaluate NeedsTick
+	void RefreshTick();
+
+	// call before sending any RPC from the character, stat Tantrumn shows the per frame total and
+	// CSV captures get a RPCsSent_<Name> column per character
+	void CountRPCSent();
+	FName RPCsSentStatName;
+
 	UFUNCTION()
 	void OnRep_CharacterThrowState(const ECharacterThrowState& OldCharacterThrowState);
 
+	// client side prediction of CharacterThrowState, returns the sequence number to send with the server request
+	uint8 PredictThrowState(ECharacterThrowState InCharacterThrowState);
+	// server only, acknowledges a client request together with the resulting state
+	void AckThrowState(uint8 Sequence);
+	void RollbackThrowState(ECharacterThrowState InCharacterThrowState);
+
+	UPROPERTY(ReplicatedUsing = OnRep_ThrowStateAck)
+	FCharacterThrowStateAck ThrowStateAck;
+
+	UFUNCTION()
+	void OnRep_ThrowStateAck();
+
+	static constexpr int32 MaxPendingThrowStates = 32;
+	TArray<FPendingThrowState, TInlineAllocator<MaxPendingThrowStates>> PendingThrowStates;
+	uint8 LocalThrowStateSequence = 0;
+
+	// timing checks reported to UTantrumnThrowMetricsSubsystem, times are real seconds so net lag is included
+	void UpdateThrowStateTiming(ECharacterThrowState OldCharacterThrowState);
+	void OnThrowStateStuck();
+	float PullStartTime = -1.0f;
+	float ThrowPredictTime = -1.0f;
+	uint8 ThrowPredictSequence = 0;
+	FTimerHandle StuckThrowStateTimerHandle;
+
 	UPROPERTY(EditAnywhere, Category = "Throw", meta = (ClampMin = "0.0", Unit = "ms"))
 	float ThrowSpeed = 2000.0f;
 
 	UPROPERTY(EditAnywhere, Category = "Animation")
 	UAnimMontage* ThrowMontage = nullptr;
 
+	// montage time covered by each baked play rate step, smaller follows the ThrowCurve more closely
+	UPROPERTY(EditAnywhere, Category = "Animation", meta = (ClampMin = "0.01", Units = "s"))
+	float ThrowPlayRateStepLength = 0.1f;
+
 	UPROPERTY(EditAnywhere, Category = "Animation")
 	UAnimMontage* CelebrateMontage = nullptr;
 
-	FOnMontageBlendingOutStarted BlendingOutDelegate;
-	FOnMontageEnded MontageEndedDelegate;
+	FTraceDelegate AsyncTraceDelegate;
+	FTraceHandle PendingTraceHandle;
+
+	UPROPERTY(VisibleAnywhere, Category = "Network")
+	UTantrumnLagCompensationComponent* LagCompensationComponent;
+
+	UPROPERTY(VisibleAnywhere, Category = "Effect")
+	UTantrumnStatusEffectComponent* StatusEffectComponent;
 
 	UPROPERTY(replicated)
 	FVector LastGroundPosition = FVector::ZeroVector;
@@ -198,14 +376,4 @@ private:
 	AThrowableActor* ThrowableActor;
 
 	void ApplyEffect_Implementation(EEffectType EffectType, bool bIsBuff) override;
-	void UpdateEffect(float DeltaTime);
-	void EndEffect();
-
-	bool bIsUnderEffect = false;
-	bool bIsEffectBuff = false;
-
-	float DefaultEffectCooldown = 5.0f;
-	float EffectCooldown = 0.0f;
-
-	EEffectType CurrentEffect = EEffectType::None;
 };
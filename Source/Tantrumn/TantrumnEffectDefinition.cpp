@@ -0,0 +1,12 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TantrumnEffectDefinition.h"
+
+uint32 UTantrumnEffectDefinition::GetAttributeMask(bool bIsBuff) const {
+	uint32 AttributeMask = 0;
+	for (const FTantrumnAttributeModifier& Modifier : GetModifiers(bIsBuff)) {
+		AttributeMask |= 1u << (uint32)Modifier.Attribute;
+	}
+	return AttributeMask;
+}
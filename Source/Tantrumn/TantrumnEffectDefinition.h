@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "TantrumnEffectDefinition.generated.h"
+
+// character values effects can modify, the cached attribute set keeps one value per entry
+UENUM(BlueprintType)
+enum class ETantrumnAttribute : uint8 {
+	WalkSpeed		UMETA(DisplayName = "WalkSpeed"),
+	SprintSpeed		UMETA(DisplayName = "SprintSpeed"),
+	JumpZVelocity	UMETA(DisplayName = "JumpZVelocity"),
+	ThrowSpeed		UMETA(DisplayName = "ThrowSpeed"),
+	// scales the stun this character's throws cause
+	ThrowPower		UMETA(DisplayName = "ThrowPower"),
+	Count			UMETA(Hidden),
+};
+
+UENUM(BlueprintType)
+enum class ETantrumnModifierOp : uint8 {
+	Add			UMETA(DisplayName = "Add"),
+	Multiply	UMETA(DisplayName = "Multiply"),
+};
+
+UENUM(BlueprintType)
+enum class ETantrumnEffectStackPolicy : uint8 {
+	// applying again only restarts the duration
+	Refresh	UMETA(DisplayName = "Refresh"),
+	// applying again adds a stack up to MaxStacks and restarts the duration
+	Stack	UMETA(DisplayName = "Stack"),
+};
+
+USTRUCT(BlueprintType)
+struct FTantrumnAttributeModifier {
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	ETantrumnAttribute Attribute = ETantrumnAttribute::WalkSpeed;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	ETantrumnModifierOp Operation = ETantrumnModifierOp::Multiply;
+
+	// applied once per stack, adds are summed and multiplies compounded
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	float Magnitude = 1.0f;
+};
+
+/**
+ * Describes what an EEffectType does as a buff and as a debuff.
+ */
+UCLASS(BlueprintType)
+class TANTRUMN_API UTantrumnEffectDefinition : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Effect", meta = (ClampMin = "0.0", Units = "s"))
+	float Duration = 5.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Effect")
+	ETantrumnEffectStackPolicy StackPolicy = ETantrumnEffectStackPolicy::Refresh;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Effect", meta = (ClampMin = "1", EditCondition = "StackPolicy == ETantrumnEffectStackPolicy::Stack"))
+	uint8 MaxStacks = 1;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Effect")
+	TArray<FTantrumnAttributeModifier> BuffModifiers;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Effect")
+	TArray<FTantrumnAttributeModifier> DebuffModifiers;
+
+	const TArray<FTantrumnAttributeModifier>& GetModifiers(bool bIsBuff) const { return bIsBuff ? BuffModifiers : DebuffModifiers; }
+
+	// bit per ETantrumnAttribute touched, so only those attributes are recalculated
+	uint32 GetAttributeMask(bool bIsBuff) const;
+};
@@ -2,89 +2,235 @@
 
 
 #include "TantrumnGameModeBase.h"
+#include "Tantrumn.h"
 #include "Kismet/GameplayStatics.h"
 #include "GameFramework/Character.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerStart.h"
+#include "BrainComponent.h"
+#include "Engine/DemoNetDriver.h"
+#include "EngineUtils.h"
 #include "TantrumnGameInstance.h"
 #include "TantrumnGameStateBase.h"
 #include "TantrumnPlayerController.h"
+#include "TantrumnReplaySpectatorController.h"
 #include "TantrumnPlayerState.h"
+#include "TantrumnSoakSubsystem.h"
 #include "TantrumnAIController.h"
+#include "TantrumnLevelResetSubsystem.h"
+#include "TantrumnMapPreloadSubsystem.h"
+#include "TantrumnMatch.h"
+#include "TantrumnThrowablePoolSubsystem.h"
+#include "ThrowableActor.h"
 
 #include "TantrumnGameWidget.h"
 
+DECLARE_CYCLE_STAT(TEXT("Attempt Start Game"), STAT_TantrumnAttemptStartGame, STATGROUP_Tantrumn);
+DECLARE_CYCLE_STAT(TEXT("Start Game"), STAT_TantrumnStartGame, STATGROUP_Tantrumn);
+DECLARE_CYCLE_STAT(TEXT("Restart Game"), STAT_TantrumnRestartGame, STATGROUP_Tantrumn);
+
+DEFINE_LOG_CATEGORY_STATIC(LogTantrumnReplay, Log, All)
+
+static TAutoConsoleVariable<int32> CVarRecordReplays(
+	TEXT("Tantrumn.Replay.Record"),
+	0,
+	TEXT("Record a replay on the server from the first match starting to play until no match is playing"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarReplayCheckpointInterval(
+	TEXT("Tantrumn.Replay.CheckpointInterval"),
+	10.0f,
+	TEXT("Seconds between full checkpoints in recorded replays, shorter intervals scrub faster but record more"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarReplayRecordHz(
+	TEXT("Tantrumn.Replay.RecordHz"),
+	10.0f,
+	TEXT("Frames per second written to recorded replays, frames between them only hold changed properties"),
+	ECVF_Default
+);
+
 ATantrumnGameModeBase::ATantrumnGameModeBase() {
 	PrimaryActorTick.bCanEverTick = false;
+	bUseSeamlessTravel = true;
+	ReplaySpectatorPlayerControllerClass = ATantrumnReplaySpectatorController::StaticClass();
 }
 
 void ATantrumnGameModeBase::BeginPlay() {
 	Super::BeginPlay();
 
-	if (ATantrumnGameStateBase* TantrumnGameState = GetGameState<ATantrumnGameStateBase>()) {
-		TantrumnGameState->SetGameState(EGameState::Waiting);
+	InitializeMatches();
+	for (ATantrumnMatch* Match : Matches) {
+		Match->SetMatchState(EGameState::Waiting);
+	}
+
+	if (UTantrumnThrowablePoolSubsystem* PoolSubsystem = GetWorld()->GetSubsystem<UTantrumnThrowablePoolSubsystem>()) {
+		for (const TPair<TSoftClassPtr<AThrowableActor>, int32>& PoolSize : ThrowablePoolSizes) {
+			if (UClass* ThrowableClass = PoolSize.Key.LoadSynchronous()) {
+				PoolSubsystem->Prewarm(ThrowableClass, PoolSize.Value);
+			}
+		}
+	}
+
+	// only exists when launched with -TantrumnSoak
+	if (UTantrumnSoakSubsystem* SoakSubsystem = GetWorld()->GetSubsystem<UTantrumnSoakSubsystem>()) {
+		SoakSubsystem->BeginSoak(this);
+	}
+}
+
+void ATantrumnGameModeBase::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+	// a replay covers one map, travel closes it
+	StopReplayRecording();
+	Super::EndPlay(EndPlayReason);
+}
+
+void ATantrumnGameModeBase::InitializeMatches() {
+	if (Matches.Num() > 0) {
+		return;
+	}
+	for (TActorIterator<ATantrumnMatch> It(GetWorld()); It; ++It) {
+		It->SetMatchId(Matches.Num());
+		Matches.Add(*It);
+	}
+	// maps without placed matches run a single race over the whole level
+	if (Matches.Num() == 0) {
+		CreateMatch();
+	}
+}
+
+ATantrumnMatch* ATantrumnGameModeBase::CreateMatch() {
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.Owner = this;
+	ATantrumnMatch* Match = GetWorld()->SpawnActor<ATantrumnMatch>(SpawnParams);
+	if (Match) {
+		Match->SetMatchId(Matches.Num());
+		Matches.Add(Match);
 	}
+	return Match;
 }
 
-void ATantrumnGameModeBase::AttemptStartGame() {
-	if (ATantrumnGameStateBase* TantrumnGameState = GetGameState<ATantrumnGameStateBase>()) {
-		TantrumnGameState->SetGameState(EGameState::Waiting);
+ATantrumnMatch* ATantrumnGameModeBase::AssignToMatch(AController* Controller) {
+	ATantrumnPlayerState* PlayerState = Controller ? Controller->GetPlayerState<ATantrumnPlayerState>() : nullptr;
+	if (!PlayerState) {
+		return nullptr;
 	}
-	if (GetNumPlayers() == NumExpectedPlayers) {
-		// call on game instance and replicate
-		DisplayCountdown();
-		if (GameCountdownDuration > SMALL_NUMBER) {
-			GetWorld()->GetTimerManager().SetTimer(TimerHandle, this, &ATantrumnGameModeBase::StartGame, GameCountdownDuration, false);
+	if (PlayerState->GetMatch()) {
+		return PlayerState->GetMatch();
+	}
+
+	// ai can possess before BeginPlay
+	InitializeMatches();
+
+	ATantrumnMatch* Match = nullptr;
+	if (PlayerState->IsABot()) {
+		// ai placed on a track belongs to that track's match
+		for (ATantrumnMatch* InMatch : Matches) {
+			if (InMatch->HasAIParticipant(Controller->GetPawn())) {
+				Match = InMatch;
+				break;
+			}
 		}
-		else {
-			//called from authority
-			StartGame();
+	}
+	if (!Match) {
+		for (ATantrumnMatch* InMatch : Matches) {
+			if (InMatch->IsAcceptingPlayers() && (PlayerState->IsABot() || InMatch->GetNumHumanPlayers() < NumExpectedPlayers)) {
+				Match = InMatch;
+				break;
+			}
 		}
 	}
+	if (!Match && Matches.Num() < FMath::Max<uint8>(MaxConcurrentMatches, 1u)) {
+		Match = CreateMatch();
+	}
+
+	if (Match) {
+		Match->AddPlayer(PlayerState);
+	}
+	else {
+		UE_LOG(LogTantrumnGameState, Warning, TEXT("ATantrumnGameModeBase::AssignToMatch no match has room for %s"), *Controller->GetName());
+	}
+	return Match;
 }
 
-void ATantrumnGameModeBase::DisplayCountdown() {
-	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator) {
-		APlayerController* PlayerController = Iterator->Get();
-		if (PlayerController && PlayerController->PlayerState && !MustSpectate(PlayerController)) {
-			if (ATantrumnPlayerController* TantrumnPlayerController = Cast<ATantrumnPlayerController>(PlayerController)) {
-				TantrumnPlayerController->ClientDisplayCountdown(GameCountdownDuration, GameWidgetClass);
-			}
+void ATantrumnGameModeBase::AttemptStartGame(ATantrumnMatch* Match) {
+	TANTRUMN_SCOPE_CYCLE_COUNTER(STAT_TantrumnAttemptStartGame);
+	CSV_SCOPED_TIMING_STAT(Tantrumn, AttemptStartGame);
+	if (!Match) {
+		return;
+	}
+	Match->SetMatchState(EGameState::Waiting);
+	if (Match->GetNumHumanPlayers() == NumExpectedPlayers) {
+		BeginCountdown(Match);
+	}
+}
+
+void ATantrumnGameModeBase::StartMatchesWithoutPlayers() {
+	for (ATantrumnMatch* Match : Matches) {
+		if (Match->GetPlayers().Num() > 0) {
+			Match->SetMatchState(EGameState::Waiting);
+			BeginCountdown(Match);
 		}
 	}
 }
 
-void ATantrumnGameModeBase::StartGame() {
-	if (ATantrumnGameStateBase* TantrumnGameState = GetGameState<ATantrumnGameStateBase>()) {
-		TantrumnGameState->SetGameState(EGameState::Playing);
-		TantrumnGameState->ClearResults();
+void ATantrumnGameModeBase::BeginCountdown(ATantrumnMatch* Match) {
+	// call on game instance and replicate
+	DisplayCountdown(Match);
+	if (GameCountdownDuration > SMALL_NUMBER) {
+		FTimerDelegate StartGameDelegate = FTimerDelegate::CreateUObject(this, &ATantrumnGameModeBase::StartGame, Match);
+		GetWorld()->GetTimerManager().SetTimer(Match->TimerHandle, StartGameDelegate, GameCountdownDuration, false);
 	}
-	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator) {
-		APlayerController* PlayerController = Iterator->Get();
-		if (PlayerController && PlayerController->PlayerState && !MustSpectate(PlayerController)) {
-			FInputModeGameOnly InputMode;
-			PlayerController->SetInputMode(InputMode);
-			PlayerController->SetShowMouseCursor(false);
+	else {
+		//called from authority
+		StartGame(Match);
+	}
+}
 
-			ATantrumnPlayerState* PlayerState = PlayerController->GetPlayerState<ATantrumnPlayerState>();
-			if (PlayerState) {
-				PlayerState->SetCurrentState(EPlayerGameState::Playing);
-				PlayerState->SetIsWinner(false);
-			}
+void ATantrumnGameModeBase::DisplayCountdown(ATantrumnMatch* Match) {
+	for (ATantrumnPlayerState* PlayerState : Match->GetPlayers()) {
+		ATantrumnPlayerController* TantrumnPlayerController = PlayerState ? Cast<ATantrumnPlayerController>(PlayerState->GetOwner()) : nullptr;
+		if (TantrumnPlayerController && !MustSpectate(TantrumnPlayerController)) {
+			TantrumnPlayerController->ClientDisplayCountdown(GameCountdownDuration, GameWidgetClass);
 		}
 	}
-	for (FConstControllerIterator Iterator = GetWorld()->GetControllerIterator(); Iterator; ++Iterator) {
-		ATantrumnAIController* TantrumnAIController = Cast<ATantrumnAIController>(Iterator->Get());
-		if (TantrumnAIController) {
-			ATantrumnPlayerState* PlayerState = TantrumnAIController->GetPlayerState<ATantrumnPlayerState>();
-			if (PlayerState) {
-				PlayerState->SetCurrentState(EPlayerGameState::Playing);
-				PlayerState->SetIsWinner(false);
+}
+
+void ATantrumnGameModeBase::StartGame(ATantrumnMatch* Match) {
+	TANTRUMN_SCOPE_CYCLE_COUNTER(STAT_TantrumnStartGame);
+	CSV_SCOPED_TIMING_STAT(Tantrumn, StartGame);
+	if (!Match) {
+		return;
+	}
+	Match->SetMatchState(EGameState::Playing);
+	Match->ClearResults();
+
+	if (UTantrumnLevelResetSubsystem* ResetSubsystem = GetWorld()->GetSubsystem<UTantrumnLevelResetSubsystem>()) {
+		ResetSubsystem->CaptureMatch(Match);
+	}
+
+	for (ATantrumnPlayerState* PlayerState : Match->GetPlayers()) {
+		if (!PlayerState) {
+			continue;
+		}
+		if (APlayerController* PlayerController = Cast<APlayerController>(PlayerState->GetOwner())) {
+			if (MustSpectate(PlayerController)) {
+				continue;
 			}
+			FInputModeGameOnly InputMode;
+			PlayerController->SetInputMode(InputMode);
+			PlayerController->SetShowMouseCursor(false);
 		}
+		PlayerState->SetCurrentState(EPlayerGameState::Playing);
+		PlayerState->SetIsWinner(false);
 	}
 }
 
 void ATantrumnGameModeBase::RestartPlayer(AController* NewPlayer) {
+	// the match decides which player starts are used, so join it before spawning
+	ATantrumnMatch* Match = AssignToMatch(NewPlayer);
+
 	Super::RestartPlayer(NewPlayer);
 
 	if (APlayerController* PlayerController = Cast<APlayerController>(NewPlayer)) {
@@ -96,24 +242,175 @@ void ATantrumnGameModeBase::RestartPlayer(AController* NewPlayer) {
 			}
 		}
 	}
-	AttemptStartGame();
+	AttemptStartGame(Match);
+}
+
+void ATantrumnGameModeBase::Logout(AController* Exiting) {
+	if (ATantrumnPlayerState* PlayerState = Exiting ? Exiting->GetPlayerState<ATantrumnPlayerState>() : nullptr) {
+		if (ATantrumnMatch* Match = PlayerState->GetMatch()) {
+			Match->RemovePlayer(PlayerState);
+		}
+	}
+	Super::Logout(Exiting);
+}
+
+AActor* ATantrumnGameModeBase::ChoosePlayerStart_Implementation(AController* Player) {
+	const ATantrumnPlayerState* PlayerState = Player ? Player->GetPlayerState<ATantrumnPlayerState>() : nullptr;
+	const ATantrumnMatch* Match = PlayerState ? PlayerState->GetMatch() : nullptr;
+	if (Match) {
+		// matches without a tag look for starts tagged Match<Id>, falling back to any start
+		const FName StartTag = Match->GetPlayerStartTag().IsNone() ? FName(*FString::Printf(TEXT("Match%d"), Match->GetMatchId())) : Match->GetPlayerStartTag();
+		TArray<APlayerStart*> MatchStarts;
+		for (TActorIterator<APlayerStart> It(GetWorld()); It; ++It) {
+			if (It->PlayerStartTag == StartTag) {
+				MatchStarts.Add(*It);
+			}
+		}
+		if (MatchStarts.Num() > 0) {
+			const int32 PlayerIndex = FMath::Max(Match->GetPlayers().IndexOfByKey(PlayerState), 0);
+			return MatchStarts[PlayerIndex % MatchStarts.Num()];
+		}
+	}
+	return Super::ChoosePlayerStart_Implementation(Player);
 }
 
-void ATantrumnGameModeBase::RestartGame() {
-	for (FConstControllerIterator Iterator = GetWorld()->GetControllerIterator(); Iterator; ++Iterator) {
-		ATantrumnAIController* TantrumnAIController = Cast<ATantrumnAIController>(Iterator->Get());
-		if (TantrumnAIController && TantrumnAIController->GetPawn()) {
-			TantrumnAIController->Destroy(true);
+void ATantrumnGameModeBase::RestartGame(ATantrumnMatch* Match) {
+	TANTRUMN_SCOPE_CYCLE_COUNTER(STAT_TantrumnRestartGame);
+	CSV_SCOPED_TIMING_STAT(Tantrumn, RestartGame);
+	if (!Match) {
+		return;
+	}
+	GetWorld()->GetTimerManager().ClearTimer(Match->TimerHandle);
+
+	// pawns are kept and moved back, only actors that changed since the match started are touched
+	if (UTantrumnLevelResetSubsystem* ResetSubsystem = GetWorld()->GetSubsystem<UTantrumnLevelResetSubsystem>()) {
+		// with a single match the whole level belongs to it, otherwise other matches are still racing
+		if (Matches.Num() <= 1) {
+			ResetSubsystem->RestoreAll();
+		}
+		else {
+			ResetSubsystem->RestoreMatch(Match);
 		}
 	}
-	ResetLevel();
-	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator) {
-		APlayerController* PlayerController = Iterator->Get();
-		if (PlayerController && PlayerController->PlayerState && !MustSpectate(PlayerController)) {
-			if (ATantrumnPlayerController* TantrumnPlayerController = Cast<ATantrumnPlayerController>(PlayerController)) {
+
+	const TArray<ATantrumnPlayerState*> MatchPlayers = Match->GetPlayers();
+	for (ATantrumnPlayerState* PlayerState : MatchPlayers) {
+		AController* Controller = PlayerState ? Cast<AController>(PlayerState->GetOwner()) : nullptr;
+		if (ATantrumnPlayerController* TantrumnPlayerController = Cast<ATantrumnPlayerController>(Controller)) {
+			if (!MustSpectate(TantrumnPlayerController)) {
 				TantrumnPlayerController->ClientRestartGame();
+				RestartPlayer(TantrumnPlayerController);
+			}
+		}
+		else if (ATantrumnAIController* TantrumnAIController = Cast<ATantrumnAIController>(Controller)) {
+			TantrumnAIController->StopMovement();
+			if (UBrainComponent* BrainComponent = TantrumnAIController->GetBrainComponent()) {
+				BrainComponent->RestartLogic();
 			}
-			RestartPlayer(PlayerController);
+			PlayerState->SetCurrentState(EPlayerGameState::Waiting);
+		}
+	}
+}
+
+void ATantrumnGameModeBase::HandleSeamlessTravelPlayer(AController*& C) {
+	// player states carry over but the matches they belonged to stayed in the old world
+	if (ATantrumnPlayerState* PlayerState = C ? C->GetPlayerState<ATantrumnPlayerState>() : nullptr) {
+		PlayerState->SetMatch(nullptr);
+		PlayerState->SetCurrentState(EPlayerGameState::None);
+		PlayerState->SetIsWinner(false);
+	}
+	Super::HandleSeamlessTravelPlayer(C);
+}
+
+FString ATantrumnGameModeBase::GetNextMapPackageName() const {
+	if (MapRotation.Num() == 0) {
+		return FString();
+	}
+
+	const FString CurrentMapName = UWorld::RemovePIEPrefix(GetWorld()->GetOutermost()->GetName());
+	const int32 CurrentIndex = MapRotation.IndexOfByPredicate([&CurrentMapName](const TSoftObjectPtr<UWorld>& Map) { return Map.GetLongPackageName() == CurrentMapName; });
+	return MapRotation[(CurrentIndex + 1) % MapRotation.Num()].GetLongPackageName();
+}
+
+void ATantrumnGameModeBase::PreloadNextMap() {
+	if (UTantrumnMapPreloadSubsystem* PreloadSubsystem = GetGameInstance()->GetSubsystem<UTantrumnMapPreloadSubsystem>()) {
+		PreloadSubsystem->PreloadMap(GetNextMapPackageName());
+	}
+}
+
+void ATantrumnGameModeBase::TravelToNextMap(ATantrumnMatch* Match) {
+	const FString NextMapPackageName = GetNextMapPackageName();
+	// travel takes the whole world along, only possible while a single match is running
+	if (NextMapPackageName.IsEmpty() || Matches.Num() > 1) {
+		RestartGame(Match);
+		return;
+	}
+	GetWorld()->ServerTravel(NextMapPackageName, false);
+}
+
+bool ATantrumnGameModeBase::IsAnyMatchPlaying() const {
+	return Matches.ContainsByPredicate([](const ATantrumnMatch* Match) {
+		return Match && Match->GetMatchState() == EGameState::Playing;
+	});
+}
+
+void ATantrumnGameModeBase::UpdateReplayRecording() {
+	const bool bAnyMatchPlaying = IsAnyMatchPlaying();
+
+	if (bAnyMatchPlaying && CVarRecordReplays.GetValueOnGameThread() != 0) {
+		StartReplayRecording();
+	}
+	else if (!bAnyMatchPlaying) {
+		StopReplayRecording();
+	}
+}
+
+bool ATantrumnGameModeBase::IsRecordingReplay() const {
+	const UDemoNetDriver* DemoNetDriver = GetWorld()->GetDemoNetDriver();
+	return DemoNetDriver && DemoNetDriver->IsRecording();
+}
+
+void ATantrumnGameModeBase::StartReplayRecording() {
+	if (IsRecordingReplay()) {
+		return;
+	}
+
+	// the demo driver reads these while recording, the previous values come back once it stops. set at console
+	// priority so neither write loses to a value that came from an ini or the console
+	if (IConsoleVariable* CheckpointDelay = IConsoleManager::Get().FindConsoleVariable(TEXT("demo.CheckpointUploadDelayInSeconds"))) {
+		SavedDemoCheckpointDelay = CheckpointDelay->GetString();
+		CheckpointDelay->Set(FMath::Max(CVarReplayCheckpointInterval.GetValueOnGameThread(), 1.0f), ECVF_SetByConsole);
+	}
+	if (IConsoleVariable* RecordHz = IConsoleManager::Get().FindConsoleVariable(TEXT("demo.RecordHz"))) {
+		SavedDemoRecordHz = RecordHz->GetString();
+		RecordHz->Set(FMath::Max(CVarReplayRecordHz.GetValueOnGameThread(), 1.0f), ECVF_SetByConsole);
+	}
+
+	const FString MapName = UWorld::RemovePIEPrefix(GetWorld()->GetMapName());
+	const FString ReplayName = FString::Printf(TEXT("Tantrumn_%s_%s"), *MapName, *FDateTime::Now().ToString());
+	TArray<FString> AdditionalOptions;
+	AdditionalOptions.Add(TEXT("ReplayStreamerOverride=LocalFileNetworkReplayStreaming"));
+	GetGameInstance()->StartRecordingReplay(ReplayName, MapName, AdditionalOptions);
+	UE_LOG(LogTantrumnReplay, Log, TEXT("Recording replay %s"), *ReplayName);
+}
+
+void ATantrumnGameModeBase::StopReplayRecording() {
+	if (!IsRecordingReplay()) {
+		return;
+	}
+	GetGameInstance()->StopRecordingReplay();
+	UE_LOG(LogTantrumnReplay, Log, TEXT("Stopped recording replay"));
+
+	if (IConsoleVariable* CheckpointDelay = IConsoleManager::Get().FindConsoleVariable(TEXT("demo.CheckpointUploadDelayInSeconds"))) {
+		if (!SavedDemoCheckpointDelay.IsEmpty()) {
+			CheckpointDelay->Set(*SavedDemoCheckpointDelay, ECVF_SetByConsole);
 		}
 	}
-}
\ No newline at end of file
+	if (IConsoleVariable* RecordHz = IConsoleManager::Get().FindConsoleVariable(TEXT("demo.RecordHz"))) {
+		if (!SavedDemoRecordHz.IsEmpty()) {
+			RecordHz->Set(*SavedDemoRecordHz, ECVF_SetByConsole);
+		}
+	}
+	SavedDemoCheckpointDelay.Reset();
+	SavedDemoRecordHz.Reset();
+}
@@ -8,6 +8,8 @@
 #include "TantrumnGameModeBase.generated.h"
 
 class AController;
+class AThrowableActor;
+class ATantrumnMatch;
 class ATantrumnPlayerController;
 
 UCLASS()
@@ -19,9 +21,36 @@ public:
 	ATantrumnGameModeBase();
 
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void RestartPlayer(AController* NewPlayer) override;
+	virtual void Logout(AController* Exiting) override;
+	virtual AActor* ChoosePlayerStart_Implementation(AController* Player) override;
 
-	void RestartGame();
+	// puts the controller's player into a match that is still waiting for players, creating one if allowed
+	ATantrumnMatch* AssignToMatch(AController* Controller);
+
+	void RestartGame(ATantrumnMatch* Match);
+
+	virtual void HandleSeamlessTravelPlayer(AController*& C) override;
+
+	// map that follows the current one in MapRotation, empty if there is no rotation
+	FString GetNextMapPackageName() const;
+
+	// starts the next map's package loading in the background, called once results are showing
+	void PreloadNextMap();
+
+	// seamless travel to the next map in the rotation, falls back to restarting in place
+	void TravelToNextMap(ATantrumnMatch* Match);
+
+	// bot only runs have no humans to wait for, starts the countdown of every match that has players
+	void StartMatchesWithoutPlayers();
+
+	const TArray<ATantrumnMatch*>& GetMatches() const { return Matches; }
+
+	bool IsAnyMatchPlaying() const;
+
+	// records while any match is playing when Tantrumn.Replay.Record is set, called on every match state change
+	void UpdateReplayRecording();
 
 private:
 	UPROPERTY(EditAnywhere, Category = "Widget")
@@ -34,12 +63,38 @@ private:
 	UFUNCTION(BlueprintCallable, Category = "Game Details")
 	void SetNumExpectedPlayers(uint8 InNumExpectedPlayers) { NumExpectedPlayers = InNumExpectedPlayers; }
 
+	// human players needed before a match starts its countdown
 	UPROPERTY(EditAnywhere, Category = "Game Details")
 	uint8 NumExpectedPlayers = 3u;
 
-	FTimerHandle TimerHandle;
+	// matches spawned on demand when no placed match has room, each runs its own race
+	UPROPERTY(EditAnywhere, Category = "Game Details")
+	uint8 MaxConcurrentMatches = 1u;
+
+	UPROPERTY()
+	TArray<ATantrumnMatch*> Matches;
+
+	// maps played in order, seamless travel keeps controllers and player states between them
+	UPROPERTY(EditAnywhere, Category = "Travel")
+	TArray<TSoftObjectPtr<UWorld>> MapRotation;
+
+	// throwables spawned into the pool at map load so none are spawned mid match, set in DefaultGame.ini
+	UPROPERTY(EditAnywhere, Config, Category = "Pool")
+	TMap<TSoftClassPtr<AThrowableActor>, int32> ThrowablePoolSizes;
+
+	void InitializeMatches();
+	ATantrumnMatch* CreateMatch();
+
+	void BeginCountdown(ATantrumnMatch* Match);
+	void DisplayCountdown(ATantrumnMatch* Match);
+	void StartGame(ATantrumnMatch* Match);
+	void AttemptStartGame(ATantrumnMatch* Match);
+
+	void StartReplayRecording();
+	void StopReplayRecording();
+	bool IsRecordingReplay() const;
 
-	void DisplayCountdown();
-	void StartGame();
-	void AttemptStartGame();
+	// demo cvar values from before recording started, restored when it stops
+	FString SavedDemoCheckpointDelay;
+	FString SavedDemoRecordHz;
 };
@@ -2,49 +2,30 @@
 
 
 #include "TantrumnGameStateBase.h"
+#include "Tantrumn.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 #include "TantrumnCharacterBase.h"
-#include "TantrumnPlayerController.h"
+#include "TantrumnMatch.h"
 #include "TantrumnPlayerState.h"
-#include "GameFramework/CharacterMovementComponent.h"
-#include "TantrumnAIController.h"
 
-void ATantrumnGameStateBase::UpdateResults(ATantrumnPlayerState* PlayerState, ATantrumnCharacterBase* TantrumnCharacter) {
-	if (!PlayerState || !TantrumnCharacter) { return; }
-	const bool IsWinner = Results.Num() == 0;
-	PlayerState->SetIsWinner(IsWinner);
-	PlayerState->SetCurrentState(EPlayerGameState::Finished);
-
-	FGameResult Result;
-	Result.Name = TantrumnCharacter->GetName();
-	//TODO: get actual time for results widget
-	Result.Time = 5.0f;
-	Results.Add(Result);
+void ATantrumnGameStateBase::SetGameState(EGameState InGameState) {
+	if (GameState != InGameState) {
+		GameState = InGameState;
+		MARK_PROPERTY_DIRTY_FROM_NAME(ATantrumnGameStateBase, GameState, this);
+	}
 }
 
 void ATantrumnGameStateBase::OnPlayerReachedEnd(ATantrumnCharacterBase* TantrumnCharacter) {
 	ensureMsgf(HasAuthority(), TEXT("ATantrumnGameStateBase::OnPlayerReachedEnd being called from Non Authority!"));
-	if (ATantrumnPlayerController* TantrumnPlayerController = TantrumnCharacter->GetController<ATantrumnPlayerController>()) {
-		TantrumnPlayerController->ClientReachedEnd();
-		TantrumnCharacter->GetCharacterMovement()->DisableMovement();
-
-		ATantrumnPlayerState* PlayerState = TantrumnPlayerController->GetPlayerState<ATantrumnPlayerState>();
-		UpdateResults(PlayerState, TantrumnCharacter);
-
-		//TODO this won't work once Join-in-progress is enabled
-		if (Results.Num() >= PlayerArray.Num()) {
-			GameState = EGameState::GameOver;
+	CSV_SCOPED_TIMING_STAT(Tantrumn, OnPlayerReachedEnd);
+	if (!TantrumnCharacter) { return; }
+	if (ATantrumnPlayerState* PlayerState = TantrumnCharacter->GetPlayerState<ATantrumnPlayerState>()) {
+		if (ATantrumnMatch* Match = PlayerState->GetMatch()) {
+			CSV_EVENT(Tantrumn, TEXT("ReachedEnd Match%d"), Match->GetMatchId());
+			Match->OnPlayerReachedEnd(TantrumnCharacter);
 		}
 	}
-	else if (ATantrumnAIController* TantrumnAIController = TantrumnCharacter->GetController<ATantrumnAIController>()) {
-		ATantrumnPlayerState* PlayerState = TantrumnAIController->GetPlayerState<ATantrumnPlayerState>();
-		UpdateResults(PlayerState, TantrumnCharacter);
-		TantrumnAIController->OnReachedEnd();
-	}
-}
-
-void  ATantrumnGameStateBase::ClearResults() {
-	Results.Empty();
 }
 
 void ATantrumnGameStateBase::GetLifetimeReplicatedProps(TArray< FLifetimeProperty >& OutLifetimeProps) const {
@@ -55,7 +36,6 @@ void ATantrumnGameStateBase::GetLifetimeReplicatedProps(TArray< FLifetimePropert
 	//SharedParams.Condition = COND_SkipOwner;
 
 	DOREPLIFETIME_WITH_PARAMS_FAST(ATantrumnGameStateBase, GameState, SharedParams);
-	DOREPLIFETIME_WITH_PARAMS_FAST(ATantrumnGameStateBase, Results, SharedParams);
 }
 
 void ATantrumnGameStateBase::OnRep_GameState(const EGameState& OldGameState) {
@@ -16,7 +16,6 @@ enum class EGameState : uint8 {
 };
 
 class ATantrumnCharacterBase;
-class ATantrumnPlayerState;
 
 USTRUCT()
 struct FGameResult {
@@ -36,7 +35,7 @@ class TANTRUMN_API ATantrumnGameStateBase : public AGameStateBase
 
 public:
 	UFUNCTION(BlueprintCallable)
-	void SetGameState(EGameState InGameState) { GameState = InGameState; }
+	void SetGameState(EGameState InGameState);
 
 	UFUNCTION(BlueprintPure)
 	EGameState GetGameState() const { return GameState; }
@@ -44,21 +43,13 @@ public:
 	UFUNCTION(BlueprintPure)
 	bool IsPlaying() const { return GameState == EGameState::Playing; }
 
-	//only called with HasAuthority
+	//only called with HasAuthority, forwards to the match the character is racing in
 	void OnPlayerReachedEnd(ATantrumnCharacterBase* TantrumnCharacter);
 
-	UFUNCTION()
-	void ClearResults();
-
 protected:
-	void UpdateResults(ATantrumnPlayerState* PlayerState, ATantrumnCharacterBase* TantrumnCharacter);
-
 	UPROPERTY(VisibleAnywhere, ReplicatedUsing = OnRep_GameState, Category = "States")
 	EGameState GameState = EGameState::None;
 
 	UFUNCTION()
 	void OnRep_GameState(const EGameState& OldGameState);
-
-	UPROPERTY(VisibleAnywhere, replicated, Category = "States")
-	TArray<FGameResult> Results;
 };
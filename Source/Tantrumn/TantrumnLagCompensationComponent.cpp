@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TantrumnLagCompensationComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "GameFramework/Character.h"
+
+UTantrumnLagCompensationComponent::UTantrumnLagCompensationComponent() {
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	// record after movement so the sample matches what gets replicated this frame
+	PrimaryComponentTick.TickGroup = TG_PostPhysics;
+}
+
+void UTantrumnLagCompensationComponent::BeginPlay() {
+	Super::BeginPlay();
+	if (ACharacter* Character = Cast<ACharacter>(GetOwner())) {
+		CapsuleComponent = Character->GetCapsuleComponent();
+	}
+	// only the server validates hits
+	SetComponentTickEnabled(GetOwner()->HasAuthority() && CapsuleComponent != nullptr);
+}
+
+void UTantrumnLagCompensationComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) {
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	RecordSample();
+}
+
+void UTantrumnLagCompensationComponent::RecordSample() {
+	FTantrumnCapsuleSample& Sample = Samples[HeadIndex];
+	Sample.Time = GetWorld()->GetTimeSeconds();
+	Sample.Location = CapsuleComponent->GetComponentLocation();
+
+	HeadIndex = (HeadIndex + 1) % MaxSamples;
+	NumSamples = FMath::Min(NumSamples + 1, MaxSamples);
+}
+
+bool UTantrumnLagCompensationComponent::GetLocationAtTime(float Time, FVector& OutLocation) const {
+	if (NumSamples == 0) {
+		return false;
+	}
+
+	// walk back from the newest sample until we straddle the requested time
+	const FTantrumnCapsuleSample* Newer = &Samples[(HeadIndex - 1 + MaxSamples) % MaxSamples];
+	if (Time >= Newer->Time) {
+		OutLocation = Newer->Location;
+		return true;
+	}
+
+	for (int32 Offset = 2; Offset <= NumSamples; ++Offset) {
+		const FTantrumnCapsuleSample* Older = &Samples[(HeadIndex - Offset + MaxSamples) % MaxSamples];
+		if (Time >= Older->Time) {
+			const float Span = Newer->Time - Older->Time;
+			const float Alpha = Span > KINDA_SMALL_NUMBER ? (Time - Older->Time) / Span : 1.0f;
+			OutLocation = FMath::Lerp(Older->Location, Newer->Location, Alpha);
+			return true;
+		}
+		Newer = Older;
+	}
+
+	OutLocation = Newer->Location;
+	return true;
+}
+
+bool UTantrumnLagCompensationComponent::SegmentHitsCapsuleAtTime(const FVector& Start, const FVector& End, float Radius, float Time) const {
+	FVector CapsuleCenter;
+	if (!CapsuleComponent || !GetLocationAtTime(Time, CapsuleCenter)) {
+		return false;
+	}
+
+	// characters stay upright so the capsule axis is always world up
+	const float CapsuleRadius = CapsuleComponent->GetScaledCapsuleRadius();
+	const FVector AxisOffset = FVector(0.0f, 0.0f, CapsuleComponent->GetScaledCapsuleHalfHeight_WithoutHemisphere());
+
+	FVector SegmentPoint;
+	FVector AxisPoint;
+	FMath::SegmentDistToSegmentSafe(Start, End, CapsuleCenter - AxisOffset, CapsuleCenter + AxisOffset, SegmentPoint, AxisPoint);
+	const float HitDistance = CapsuleRadius + Radius;
+	return FVector::DistSquared(SegmentPoint, AxisPoint) <= HitDistance * HitDistance;
+}
@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "TantrumnLagCompensationComponent.generated.h"
+
+class UCapsuleComponent;
+
+struct FTantrumnCapsuleSample {
+	float Time = 0.0f;
+	FVector Location = FVector::ZeroVector;
+};
+
+/**
+ * Server only history of the owning character's capsule, used to rewind targets
+ * to what a high ping thrower saw when validating throwable hits.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class TANTRUMN_API UTantrumnLagCompensationComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UTantrumnLagCompensationComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	// capsule center at the given server time, clamped to the oldest sample kept
+	bool GetLocationAtTime(float Time, FVector& OutLocation) const;
+
+	// tests the segment against the capsule as it was at Time, Radius is the radius of the swept object
+	bool SegmentHitsCapsuleAtTime(const FVector& Start, const FVector& End, float Radius, float Time) const;
+
+	// fixed history length, at 60Hz this covers just over a second
+	static constexpr int32 MaxSamples = 64;
+
+protected:
+	virtual void BeginPlay() override;
+
+	void RecordSample();
+
+	UPROPERTY()
+	UCapsuleComponent* CapsuleComponent = nullptr;
+
+	FTantrumnCapsuleSample Samples[MaxSamples];
+
+	// index the next sample is written to
+	int32 HeadIndex = 0;
+	int32 NumSamples = 0;
+};
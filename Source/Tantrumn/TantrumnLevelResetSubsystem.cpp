@@ -0,0 +1,132 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TantrumnLevelResetSubsystem.h"
+#include "EngineUtils.h"
+#include "TantrumnCharacterBase.h"
+#include "TantrumnLevelEndTrigger.h"
+#include "TantrumnMatch.h"
+#include "TantrumnPlayerState.h"
+#include "TantrumnThrowablePoolSubsystem.h"
+#include "ThrowableActor.h"
+
+void UTantrumnLevelResetSubsystem::Deinitialize() {
+	Snapshots.Empty();
+	Super::Deinitialize();
+}
+
+void UTantrumnLevelResetSubsystem::CaptureActor(AActor* InActor) {
+	if (!InActor || Snapshots.Contains(InActor)) {
+		return;
+	}
+
+	FTantrumnActorSnapshot Snapshot;
+	Snapshot.Actor = InActor;
+	Snapshot.Transform = InActor->GetActorTransform();
+	Snapshot.bHidden = InActor->IsHidden();
+	Snapshot.bCollisionEnabled = InActor->GetActorEnableCollision();
+	Snapshots.Add(InActor, Snapshot);
+}
+
+void UTantrumnLevelResetSubsystem::CaptureMatch(const ATantrumnMatch* Match) {
+	// throwables sitting in the pool are put back by the pool, not by their snapshot
+	for (TActorIterator<AThrowableActor> It(GetWorld()); It; ++It) {
+		if (!It->IsPooled()) {
+			CaptureActor(*It);
+		}
+	}
+	for (TActorIterator<ATantrumnLevelEndTrigger> It(GetWorld()); It; ++It) {
+		CaptureActor(*It);
+	}
+
+	if (Match) {
+		for (const ATantrumnPlayerState* PlayerState : Match->GetPlayers()) {
+			if (PlayerState) {
+				CaptureActor(PlayerState->GetPawn());
+			}
+		}
+	}
+}
+
+void UTantrumnLevelResetSubsystem::RestoreActor(const FTantrumnActorSnapshot& Snapshot) const {
+	AActor* Actor = Snapshot.Actor.Get();
+	if (!Actor) {
+		return;
+	}
+
+	const bool bMoved = !Actor->GetActorTransform().Equals(Snapshot.Transform);
+
+	if (AThrowableActor* Throwable = Cast<AThrowableActor>(Actor)) {
+		// a used throwable now belongs to the pool, bringing it back here would leave it in the inactive list
+		if (Throwable->IsPooled()) {
+			return;
+		}
+		// untouched throwables stay dormant and send nothing
+		if (bMoved || !Throwable->IsIdle()) {
+			Throwable->ResetToIdle(Snapshot.Transform);
+		}
+		return;
+	}
+
+	if (ATantrumnCharacterBase* TantrumnCharacter = Cast<ATantrumnCharacterBase>(Actor)) {
+		TantrumnCharacter->ResetForRestart(Snapshot.Transform);
+		return;
+	}
+
+	if (bMoved) {
+		Actor->SetActorTransform(Snapshot.Transform, false, nullptr, ETeleportType::ResetPhysics);
+	}
+	if (Actor->IsHidden() != Snapshot.bHidden) {
+		Actor->SetActorHiddenInGame(Snapshot.bHidden);
+	}
+	if (Actor->GetActorEnableCollision() != Snapshot.bCollisionEnabled) {
+		Actor->SetActorEnableCollision(Snapshot.bCollisionEnabled);
+	}
+}
+
+void UTantrumnLevelResetSubsystem::RestoreAll() {
+	// spots whose throwable was used up, taken out first so a refill cannot hand out another spot's throwable
+	TArray<FTantrumnActorSnapshot> EmptySpots;
+	for (auto It = Snapshots.CreateIterator(); It; ++It) {
+		const AThrowableActor* Throwable = Cast<AThrowableActor>(It.Value().Actor.Get());
+		if (!It.Value().Actor.IsValid() || (Throwable && Throwable->IsPooled())) {
+			if (Throwable) {
+				EmptySpots.Add(It.Value());
+			}
+			It.RemoveCurrent();
+			continue;
+		}
+		RestoreActor(It.Value());
+	}
+
+	// refill from the pool so restarting never spawns, the snapshot follows whichever instance took the spot
+	if (UTantrumnThrowablePoolSubsystem* PoolSubsystem = GetWorld()->GetSubsystem<UTantrumnThrowablePoolSubsystem>()) {
+		for (FTantrumnActorSnapshot& Snapshot : EmptySpots) {
+			if (AThrowableActor* Throwable = PoolSubsystem->AcquireThrowable(Snapshot.Actor->GetClass(), Snapshot.Transform)) {
+				Snapshot.Actor = Throwable;
+				Snapshots.Add(Throwable, Snapshot);
+			}
+		}
+	}
+
+	// throwables taken from the pool mid match have no snapshot, AThrowableActor::Reset sends them back
+	for (TActorIterator<AThrowableActor> It(GetWorld()); It; ++It) {
+		if (!It->IsPooled() && !Snapshots.Contains(*It)) {
+			It->Reset();
+		}
+	}
+}
+
+void UTantrumnLevelResetSubsystem::RestoreMatch(const ATantrumnMatch* Match) {
+	if (!Match) {
+		return;
+	}
+	for (const ATantrumnPlayerState* PlayerState : Match->GetPlayers()) {
+		if (!PlayerState) {
+			continue;
+		}
+		if (const FTantrumnActorSnapshot* Snapshot = Snapshots.Find(PlayerState->GetPawn())) {
+			RestoreActor(*Snapshot);
+		}
+	}
+}
@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TantrumnLevelResetSubsystem.generated.h"
+
+class ATantrumnMatch;
+
+// how an actor looked when its match started
+struct FTantrumnActorSnapshot {
+	TWeakObjectPtr<AActor> Actor;
+	FTransform Transform;
+	bool bHidden = false;
+	bool bCollisionEnabled = true;
+};
+
+/**
+ * Snapshots throwables, characters and level end triggers when a match starts and puts
+ * back only what changed on restart, instead of resetting and respawning the whole level.
+ */
+UCLASS()
+class TANTRUMN_API UTantrumnLevelResetSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// only called with HasAuthority, actors already captured keep their first snapshot
+	void CaptureMatch(const ATantrumnMatch* Match);
+
+	// restores every captured actor, refilling the spots of used throwables from the pool, and returns
+	// pooled throwables spawned during the match
+	void RestoreAll();
+	// restores the pawns of one match only, used while other matches are still running
+	void RestoreMatch(const ATantrumnMatch* Match);
+
+protected:
+	void CaptureActor(AActor* InActor);
+	void RestoreActor(const FTantrumnActorSnapshot& Snapshot) const;
+
+	TMap<TWeakObjectPtr<AActor>, FTantrumnActorSnapshot> Snapshots;
+};
@@ -2,11 +2,15 @@
 
 
 #include "TantrumnLocalMPCamera.h"
+#include "Tantrumn.h"
 #include "Camera/CameraComponent.h"
 #include "GameFramework/SpringArmComponent.h"
 #include "TantrumnGameModeBase.h"
 #include "GameFramework/PlayerController.h"
 #include "DrawDebugHelpers.h"
+#include "TimerManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Local MP Camera Tick"), STAT_TantrumnLocalMPCameraTick, STATGROUP_Tantrumn);
 
 static TAutoConsoleVariable<bool> CVarDrawMidPoint(
 	TEXT("Tantrumn.Camera.Debug.DrawMidPoint"),
@@ -31,6 +35,7 @@ ATantrumnLocalMPCamera::ATantrumnLocalMPCamera(const FObjectInitializer& ObjectI
 
 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
 }
 
 // Called when the game starts or when spawned
@@ -39,11 +44,39 @@ void ATantrumnLocalMPCamera::BeginPlay()
 	Super::BeginPlay();
 	ensureMsgf(GetWorld(), TEXT("ATantrumnLocalMPCamera::BeginPlay() Missing World!"));
 	TantrumnGameModeBase = Cast<ATantrumnGameModeBase>(GetWorld()->GetAuthGameMode());
+
+	UpdateTickEnabled();
+	GetWorldTimerManager().SetTimer(TickEnabledTimerHandle, this, &ATantrumnLocalMPCamera::UpdateTickEnabled, TickEnabledCheckInterval, true);
+}
+
+void ATantrumnLocalMPCamera::UpdateTickEnabled() {
+	const bool bShouldTick = GetNumPlayersWithPawns() > 1;
+	if (bShouldTick == IsActorTickEnabled()) {
+		return;
+	}
+
+	SetActorTickEnabled(bShouldTick);
+	if (!bShouldTick) {
+		// what Tick settles on with a single player
+		SpringArmComponent->TargetArmLength = MinArmLength;
+	}
+}
+
+int32 ATantrumnLocalMPCamera::GetNumPlayersWithPawns() const {
+	int32 NumPlayers = 0;
+	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator) {
+		APlayerController* PlayerController = Iterator->Get();
+		if (PlayerController && PlayerController->PlayerState && PlayerController->GetPawn()) {
+			++NumPlayers;
+		}
+	}
+	return NumPlayers;
 }
 
 // Called every frame
 void ATantrumnLocalMPCamera::Tick(float DeltaTime)
 {
+	TANTRUMN_SCOPE_CYCLE_COUNTER(STAT_TantrumnLocalMPCameraTick);
 	Super::Tick(DeltaTime);
 
 	float MaxDistanceSq = 0.0f;
@@ -52,7 +85,7 @@ void ATantrumnLocalMPCamera::Tick(float DeltaTime)
 	int NumPlayers = 0;
 	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator) {
 		APlayerController* PlayerController = Iterator->Get();
-		if (PlayerController && PlayerController->PlayerState) {
+		if (PlayerController && PlayerController->PlayerState && PlayerController->GetPawn()) {
 			FVector PawnPosition = PlayerController->GetPawn()->GetActorLocation();
 			if (!LastPosition.IsNearlyZero()) {
 				const float DistanceSq = (PawnPosition - LastPosition).SizeSquared();
@@ -68,9 +101,11 @@ void ATantrumnLocalMPCamera::Tick(float DeltaTime)
 
 	MidPoint /= NumPlayers > 0 ? (float)NumPlayers : 1.0f;
 
+#if ENABLE_DRAW_DEBUG
 	if (CVarDrawMidPoint->GetBool()) {
 		DrawDebugSphere(GetWorld(), MidPoint, 25.0f, 10, FColor::Blue);
 	}
+#endif
 	const float MaxDistance = MaxDistanceSq > KINDA_SMALL_NUMBER ? FMath::Min(sqrtf(MaxDistanceSq), MaxPlayerDistance) : 0.0f;
 	const float DistanceRatio = MaxDistance > MinPlayerDistance ? (MaxDistance - MinPlayerDistance) / (MaxPlayerDistance - MinPlayerDistance) : 0.0f;
 	SpringArmComponent->TargetArmLength = FMath::Lerp(MinArmLength, MaxArmLength, DistanceRatio);
@@ -41,4 +41,13 @@ protected:
 	float MaxPlayerDistance = 1000.0f;
 
 	ATantrumnGameModeBase* TantrumnGameModeBase;
+
+	// with fewer than two players the arm length never changes, so tick is only enabled while there are two
+	void UpdateTickEnabled();
+	int32 GetNumPlayersWithPawns() const;
+
+	FTimerHandle TickEnabledTimerHandle;
+
+	UPROPERTY(EditAnywhere, Category = "Tick", meta = (ClampMin = "0.1"))
+	float TickEnabledCheckInterval = 0.5f;
 };
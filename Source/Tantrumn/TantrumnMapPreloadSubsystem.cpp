@@ -0,0 +1,55 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TantrumnMapPreloadSubsystem.h"
+#include "Engine/World.h"
+#include "UObject/UObjectGlobals.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogTantrumnTravel, Log, All)
+
+void UTantrumnMapPreloadSubsystem::Initialize(FSubsystemCollectionBase& Collection) {
+	Super::Initialize(Collection);
+	PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UTantrumnMapPreloadSubsystem::OnPostLoadMap);
+}
+
+void UTantrumnMapPreloadSubsystem::Deinitialize() {
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+	PreloadedPackage = nullptr;
+	PendingMapPackageName.Empty();
+	Super::Deinitialize();
+}
+
+void UTantrumnMapPreloadSubsystem::PreloadMap(const FString& MapPackageName) {
+	if (MapPackageName.IsEmpty() || MapPackageName == PendingMapPackageName || IsMapPreloaded(MapPackageName)) {
+		return;
+	}
+
+	PendingMapPackageName = MapPackageName;
+	LoadPackageAsync(MapPackageName, FLoadPackageAsyncDelegate::CreateUObject(this, &UTantrumnMapPreloadSubsystem::OnPreloadCompleted));
+}
+
+bool UTantrumnMapPreloadSubsystem::IsMapPreloaded(const FString& MapPackageName) const {
+	return PreloadedPackage && PreloadedPackage->GetName() == MapPackageName;
+}
+
+void UTantrumnMapPreloadSubsystem::OnPreloadCompleted(const FName& PackageName, UPackage* LoadedPackage, EAsyncLoadingResult::Type Result) {
+	// a newer request replaced this one while it was loading
+	if (PackageName.ToString() != PendingMapPackageName) {
+		return;
+	}
+
+	PendingMapPackageName.Empty();
+	if (Result == EAsyncLoadingResult::Succeeded) {
+		PreloadedPackage = LoadedPackage;
+	}
+	else {
+		UE_LOG(LogTantrumnTravel, Warning, TEXT("UTantrumnMapPreloadSubsystem failed to preload %s"), *PackageName.ToString());
+	}
+}
+
+void UTantrumnMapPreloadSubsystem::OnPostLoadMap(UWorld* LoadedWorld) {
+	// the world owns the package now, holding on to it would leak it past the next travel
+	if (PreloadedPackage && LoadedWorld && LoadedWorld->GetOutermost() == PreloadedPackage) {
+		PreloadedPackage = nullptr;
+	}
+}
@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "TantrumnMapPreloadSubsystem.generated.h"
+
+/**
+ * Streams the next map's package in the background while the results are shown, so travel
+ * only has to pick up an already loaded package. Lives on the game instance so the package
+ * stays referenced through the transition map's garbage collection.
+ */
+UCLASS()
+class TANTRUMN_API UTantrumnMapPreloadSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// long package name, e.g. /Game/Tantrumn/Maps/Playground_Kinematics
+	void PreloadMap(const FString& MapPackageName);
+
+	bool IsMapPreloaded(const FString& MapPackageName) const;
+
+protected:
+	void OnPreloadCompleted(const FName& PackageName, UPackage* LoadedPackage, EAsyncLoadingResult::Type Result);
+	void OnPostLoadMap(UWorld* LoadedWorld);
+
+	FString PendingMapPackageName;
+
+	// keeps the preloaded map alive until travel has finished with it
+	UPROPERTY()
+	UPackage* PreloadedPackage = nullptr;
+
+	FDelegateHandle PostLoadMapHandle;
+};
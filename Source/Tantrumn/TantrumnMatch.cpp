@@ -0,0 +1,155 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TantrumnMatch.h"
+#include "Tantrumn.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "TantrumnAIController.h"
+#include "TantrumnCharacterBase.h"
+#include "TantrumnGameModeBase.h"
+#include "TantrumnPlayerController.h"
+#include "TantrumnPlayerState.h"
+#include "TantrumnRoundProfilerSubsystem.h"
+
+ATantrumnMatch::ATantrumnMatch() {
+	bReplicates = true;
+	bAlwaysRelevant = true;
+	NetUpdateFrequency = 10.0f;
+}
+
+void ATantrumnMatch::SetMatchId(uint8 InMatchId) {
+	if (MatchId != InMatchId) {
+		MatchId = InMatchId;
+		MARK_PROPERTY_DIRTY_FROM_NAME(ATantrumnMatch, MatchId, this);
+	}
+}
+
+void ATantrumnMatch::SetMatchState(EGameState InMatchState) {
+	if (MatchState != InMatchState) {
+		MatchState = InMatchState;
+		MARK_PROPERTY_DIRTY_FROM_NAME(ATantrumnMatch, MatchState, this);
+		CSV_EVENT(Tantrumn, TEXT("Match%d %s"), MatchId, *UEnum::GetDisplayValueAsText(MatchState).ToString());
+
+		// a round is one stretch of play, ending or restarting closes it
+		if (UTantrumnRoundProfilerSubsystem* RoundProfiler = GetWorld()->GetSubsystem<UTantrumnRoundProfilerSubsystem>()) {
+			if (MatchState == EGameState::Playing) {
+				RoundProfiler->BeginRound(this);
+			}
+			else {
+				RoundProfiler->EndRound(this);
+			}
+		}
+
+		// only the server has a game mode
+		if (ATantrumnGameModeBase* TantrumnGameMode = GetWorld()->GetAuthGameMode<ATantrumnGameModeBase>()) {
+			TantrumnGameMode->UpdateReplayRecording();
+		}
+	}
+
+	// the game state mirrors the first match so single match maps and blueprints behave as before
+	if (MatchId == 0) {
+		if (ATantrumnGameStateBase* TantrumnGameState = GetWorld()->GetGameState<ATantrumnGameStateBase>()) {
+			TantrumnGameState->SetGameState(InMatchState);
+		}
+	}
+}
+
+void ATantrumnMatch::AddPlayer(ATantrumnPlayerState* PlayerState) {
+	if (!PlayerState || Players.Contains(PlayerState)) {
+		return;
+	}
+
+	Players.Add(PlayerState);
+	MARK_PROPERTY_DIRTY_FROM_NAME(ATantrumnMatch, Players, this);
+	PlayerState->SetMatch(this);
+}
+
+void ATantrumnMatch::RemovePlayer(ATantrumnPlayerState* PlayerState) {
+	if (Players.Remove(PlayerState) > 0) {
+		MARK_PROPERTY_DIRTY_FROM_NAME(ATantrumnMatch, Players, this);
+		if (PlayerState->GetMatch() == this) {
+			PlayerState->SetMatch(nullptr);
+		}
+	}
+}
+
+int32 ATantrumnMatch::GetNumHumanPlayers() const {
+	int32 NumHumanPlayers = 0;
+	for (const ATantrumnPlayerState* PlayerState : Players) {
+		if (PlayerState && !PlayerState->IsABot()) {
+			++NumHumanPlayers;
+		}
+	}
+	return NumHumanPlayers;
+}
+
+void ATantrumnMatch::UpdateResults(ATantrumnPlayerState* PlayerState, ATantrumnCharacterBase* TantrumnCharacter) {
+	if (!PlayerState || !TantrumnCharacter) { return; }
+	const bool IsWinner = Results.Num() == 0;
+	PlayerState->SetIsWinner(IsWinner);
+	PlayerState->SetCurrentState(EPlayerGameState::Finished);
+
+	FGameResult Result;
+	Result.Name = TantrumnCharacter->GetName();
+	//TODO: get actual time for results widget
+	Result.Time = 5.0f;
+	Results.Add(Result);
+	MARK_PROPERTY_DIRTY_FROM_NAME(ATantrumnMatch, Results, this);
+}
+
+void ATantrumnMatch::OnPlayerReachedEnd(ATantrumnCharacterBase* TantrumnCharacter) {
+	ensureMsgf(HasAuthority(), TEXT("ATantrumnMatch::OnPlayerReachedEnd being called from Non Authority!"));
+	if (ATantrumnPlayerController* TantrumnPlayerController = TantrumnCharacter->GetController<ATantrumnPlayerController>()) {
+		FString NextMapPackageName;
+		if (ATantrumnGameModeBase* TantrumnGameMode = GetWorld()->GetAuthGameMode<ATantrumnGameModeBase>()) {
+			NextMapPackageName = TantrumnGameMode->GetNextMapPackageName();
+			TantrumnGameMode->PreloadNextMap();
+		}
+		TantrumnPlayerController->ClientReachedEnd(NextMapPackageName);
+		TantrumnCharacter->GetCharacterMovement()->DisableMovement();
+
+		ATantrumnPlayerState* PlayerState = TantrumnPlayerController->GetPlayerState<ATantrumnPlayerState>();
+		UpdateResults(PlayerState, TantrumnCharacter);
+
+		//TODO this won't work once Join-in-progress is enabled
+		if (Results.Num() >= Players.Num()) {
+			SetMatchState(EGameState::GameOver);
+		}
+	}
+	else if (ATantrumnAIController* TantrumnAIController = TantrumnCharacter->GetController<ATantrumnAIController>()) {
+		ATantrumnPlayerState* PlayerState = TantrumnAIController->GetPlayerState<ATantrumnPlayerState>();
+		UpdateResults(PlayerState, TantrumnCharacter);
+		TantrumnAIController->OnReachedEnd();
+
+		// a bot can be the last to finish, bot only matches always end this way
+		if (Results.Num() >= Players.Num()) {
+			SetMatchState(EGameState::GameOver);
+		}
+	}
+}
+
+void ATantrumnMatch::ClearResults() {
+	if (Results.Num() > 0) {
+		Results.Empty();
+		MARK_PROPERTY_DIRTY_FROM_NAME(ATantrumnMatch, Results, this);
+	}
+}
+
+void ATantrumnMatch::GetLifetimeReplicatedProps(TArray< FLifetimeProperty >& OutLifetimeProps) const {
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams SharedParams;
+	SharedParams.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(ATantrumnMatch, MatchId, SharedParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ATantrumnMatch, MatchState, SharedParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ATantrumnMatch, Results, SharedParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ATantrumnMatch, Players, SharedParams);
+}
+
+void ATantrumnMatch::OnRep_MatchState(const EGameState& OldMatchState) {
+	UE_LOG(LogTantrumnGameState, Verbose, TEXT("Match %d: %s -> %s"), MatchId, *UEnum::GetDisplayValueAsText(OldMatchState).ToString(), *UEnum::GetDisplayValueAsText(MatchState).ToString());
+	CSV_EVENT(Tantrumn, TEXT("Match%d %s"), MatchId, *UEnum::GetDisplayValueAsText(MatchState).ToString());
+}
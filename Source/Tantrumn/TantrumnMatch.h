@@ -0,0 +1,90 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "TantrumnGameStateBase.h"
+#include "TantrumnMatch.generated.h"
+
+class AController;
+class ATantrumnCharacterBase;
+class ATantrumnPlayerState;
+
+/**
+ * One race running inside the server world. Owns the state, results and player set
+ * that used to live on the game state, so several matches can share a server process.
+ * Can be placed in a level per track, otherwise the game mode spawns them on demand.
+ */
+UCLASS()
+class TANTRUMN_API ATantrumnMatch : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	ATantrumnMatch();
+
+	void SetMatchId(uint8 InMatchId);
+
+	UFUNCTION(BlueprintPure)
+	uint8 GetMatchId() const { return MatchId; }
+
+	UFUNCTION(BlueprintCallable)
+	void SetMatchState(EGameState InMatchState);
+
+	UFUNCTION(BlueprintPure)
+	EGameState GetMatchState() const { return MatchState; }
+
+	UFUNCTION(BlueprintPure)
+	bool IsPlaying() const { return MatchState == EGameState::Playing; }
+
+	// a match only takes new players until its countdown starts
+	bool IsAcceptingPlayers() const { return MatchState == EGameState::None || MatchState == EGameState::Waiting; }
+
+	//only called with HasAuthority
+	void AddPlayer(ATantrumnPlayerState* PlayerState);
+	void RemovePlayer(ATantrumnPlayerState* PlayerState);
+
+	const TArray<ATantrumnPlayerState*>& GetPlayers() const { return Players; }
+	int32 GetNumHumanPlayers() const;
+
+	// true if this match was set up to run the given ai pawn
+	bool HasAIParticipant(const APawn* InPawn) const { return AIParticipants.Contains(InPawn); }
+
+	FName GetPlayerStartTag() const { return PlayerStartTag; }
+
+	//only called with HasAuthority
+	void OnPlayerReachedEnd(ATantrumnCharacterBase* TantrumnCharacter);
+
+	UFUNCTION()
+	void ClearResults();
+
+	FTimerHandle TimerHandle;
+
+protected:
+	void UpdateResults(ATantrumnPlayerState* PlayerState, ATantrumnCharacterBase* TantrumnCharacter);
+
+	// player starts with this tag are used for the players of this match, None uses any start
+	UPROPERTY(EditInstanceOnly, Category = "Match")
+	FName PlayerStartTag = NAME_None;
+
+	// ai pawns placed on this match's track
+	UPROPERTY(EditInstanceOnly, Category = "Match")
+	TArray<APawn*> AIParticipants;
+
+	UPROPERTY(VisibleAnywhere, Replicated, Category = "Match")
+	uint8 MatchId = 0;
+
+	UPROPERTY(VisibleAnywhere, ReplicatedUsing = OnRep_MatchState, Category = "States")
+	EGameState MatchState = EGameState::None;
+
+	UFUNCTION()
+	void OnRep_MatchState(const EGameState& OldMatchState);
+
+	UPROPERTY(VisibleAnywhere, Replicated, Category = "States")
+	TArray<FGameResult> Results;
+
+	UPROPERTY(VisibleAnywhere, Replicated, Category = "Match")
+	TArray<ATantrumnPlayerState*> Players;
+};
+
@@ -9,6 +9,8 @@
 #include "TantrumnGameModeBase.h"
 #include "TantrumnGameInstance.h"
 #include "TantrumnGameStateBase.h"
+#include "TantrumnMapPreloadSubsystem.h"
+#include "TantrumnMatch.h"
 #include "TantrumnPlayerState.h"
 
 static TAutoConsoleVariable<bool> CVarDisplayLaunchInputDelta(
@@ -20,7 +22,14 @@ static TAutoConsoleVariable<bool> CVarDisplayLaunchInputDelta(
 
 void ATantrumnPlayerController::BeginPlay() {
 	Super::BeginPlay();
-	TantrumnGameState = GetWorld()->GetGameState<ATantrumnGameStateBase>();
+}
+
+void ATantrumnPlayerController::NotifyLoadedWorld(FName WorldPackageName, bool bFinalDest) {
+	Super::NotifyLoadedWorld(WorldPackageName, bFinalDest);
+	// the controller survives seamless travel but its widget belonged to the old world
+	if (bFinalDest) {
+		TantrumnGameWidget = nullptr;
+	}
 }
 
 void ATantrumnPlayerController::OnPossess(APawn* aPawn) {
@@ -34,6 +43,8 @@ void ATantrumnPlayerController::OnUnPossess() {
 }
 
 void ATantrumnPlayerController::ClientDisplayCountdown_Implementation(float GameCountdownDuration, TSubclassOf<UTantrumnGameWidget> InGameWidgetClass) {
+	// dedicated servers never display ui
+#if !UE_SERVER
 	if (!TantrumnGameWidget) {
 		TantrumnGameWidget = CreateWidget<UTantrumnGameWidget>(this, InGameWidgetClass);
 	}
@@ -42,22 +53,35 @@ void ATantrumnPlayerController::ClientDisplayCountdown_Implementation(float Game
 		TantrumnGameWidget->AddToPlayerScreen();
 		TantrumnGameWidget->StartCountdown(GameCountdownDuration, this);
 	}
+#endif
 }
 
 void ATantrumnPlayerController::ClientRestartGame_Implementation() {
+	// the pawn is reused across restarts, undo the DisableMovement from ClientReachedEnd
+	if (ACharacter* ControlledCharacter = GetCharacter()) {
+		ControlledCharacter->GetCharacterMovement()->SetMovementMode(MOVE_Walking);
+	}
+
+#if !UE_SERVER
 	if (TantrumnGameWidget) {
 		TantrumnGameWidget->RemoveResults();
 		FInputModeGameOnly InputMode;
 		SetInputMode(InputMode);
 		SetShowMouseCursor(false);
 	}
+#endif
 }
 
-void ATantrumnPlayerController::ClientReachedEnd_Implementation() {
+void ATantrumnPlayerController::ClientReachedEnd_Implementation(const FString& NextMapPackageName) {
+	if (UTantrumnMapPreloadSubsystem* PreloadSubsystem = GetGameInstance()->GetSubsystem<UTantrumnMapPreloadSubsystem>()) {
+		PreloadSubsystem->PreloadMap(NextMapPackageName);
+	}
+
 	if (ATantrumnCharacterBase* TantrumnCharacterBase = Cast<ATantrumnCharacterBase>(GetCharacter())) {
 		TantrumnCharacterBase->ServerPlayCelebrateMontage();
 		TantrumnCharacterBase->GetCharacterMovement()->DisableMovement();
 
+#if !UE_SERVER
 		FInputModeUIOnly InputMode;
 		SetInputMode(InputMode);
 		SetShowMouseCursor(true);
@@ -65,6 +89,7 @@ void ATantrumnPlayerController::ClientReachedEnd_Implementation() {
 		if (TantrumnGameWidget) {
 			TantrumnGameWidget->DisplayResults();
 		}
+#endif
 	}
 }
 
@@ -72,10 +97,28 @@ void ATantrumnPlayerController::OnRetrySelected() {
 	ServerRestartLevel();
 }
 
+void ATantrumnPlayerController::OnNextMapSelected() {
+	ServerTravelToNextMap();
+}
+
+void ATantrumnPlayerController::ServerTravelToNextMap_Implementation() {
+	ATantrumnGameModeBase* TantrumnGameMode = GetWorld()->GetAuthGameMode<ATantrumnGameModeBase>();
+	if (ensureMsgf(TantrumnGameMode, TEXT("ATantrumnPlayerController::ServerTravelToNextMap_Implementation Invalid GameMode"))) {
+		// travel takes every player on the server along, only allow it once this race is over and nobody is still racing
+		ATantrumnPlayerState* TantrumnPlayerState = GetPlayerState<ATantrumnPlayerState>();
+		ATantrumnMatch* Match = TantrumnPlayerState ? TantrumnPlayerState->GetMatch() : nullptr;
+		if (Match && Match->GetMatchState() == EGameState::GameOver && !TantrumnGameMode->IsAnyMatchPlaying()) {
+			TantrumnGameMode->TravelToNextMap(Match);
+		}
+	}
+}
+
 void ATantrumnPlayerController::ServerRestartLevel_Implementation() {
 	ATantrumnGameModeBase* TantrumnGameMode = GetWorld()->GetAuthGameMode<ATantrumnGameModeBase>();
 	if (ensureMsgf(TantrumnGameMode, TEXT("ATantrumnPlayerController::ServerRestartLevel_Implementation Invalid GameMode"))) {
-		TantrumnGameMode->RestartGame();
+		if (ATantrumnPlayerState* TantrumnPlayerState = GetPlayerState<ATantrumnPlayerState>()) {
+			TantrumnGameMode->RestartGame(TantrumnPlayerState->GetMatch());
+		}
 	}
 }
 
@@ -116,10 +159,12 @@ void ATantrumnPlayerController::SetupInputComponent() {
 }
 
 bool ATantrumnPlayerController::CanProcessRequest() const {
-	if (TantrumnGameState && TantrumnGameState->IsPlaying()) {
-		if (ATantrumnPlayerState* TantrumnPlayerState = GetPlayerState<ATantrumnPlayerState>()) {
-			return (TantrumnPlayerState->GetCurrentState() == EPlayerGameState::Playing);
-		}
+	if (ATantrumnPlayerState* TantrumnPlayerState = GetPlayerState<ATantrumnPlayerState>()) {
+		// the match may not have replicated yet, the game state mirrors the first match
+		const ATantrumnMatch* Match = TantrumnPlayerState->GetMatch();
+		const ATantrumnGameStateBase* TantrumnGameState = GetWorld()->GetGameState<ATantrumnGameStateBase>();
+		const bool bIsPlaying = Match ? Match->IsPlaying() : (TantrumnGameState && TantrumnGameState->IsPlaying());
+		return bIsPlaying && (TantrumnPlayerState->GetCurrentState() == EPlayerGameState::Playing);
 	}
 	return false;
 }
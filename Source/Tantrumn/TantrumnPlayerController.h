@@ -9,7 +9,6 @@
 #include "TantrumnPlayerController.generated.h"
 
 class ATantrumnCharacterBase;
-class ATantrumnGameStateBase;
 class UTantrumnGameWidget;
 class UUserWidget;
 
@@ -32,15 +31,25 @@ public:
 	UFUNCTION(Client, Reliable)
 	void ClientRestartGame();
 
+	// NextMapPackageName is preloaded while the results are on screen, empty when there is no next map
 	UFUNCTION(Client, Reliable)
-	void ClientReachedEnd();
+	void ClientReachedEnd(const FString& NextMapPackageName);
 
 	UFUNCTION(BlueprintCallable)
 	void OnRetrySelected();
 
+	UFUNCTION(BlueprintCallable)
+	void OnNextMapSelected();
+
 	UFUNCTION(Server, Reliable)
 	void ServerRestartLevel();
 
+	UFUNCTION(Server, Reliable)
+	void ServerTravelToNextMap();
+
+	// called on the client once seamless travel has brought this controller into the new world
+	virtual void NotifyLoadedWorld(FName WorldPackageName, bool bFinalDest) override;
+
 protected:
 	virtual void SetupInputComponent() override;
 
@@ -92,9 +101,6 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "Sound")
 	USoundCue* JumpSound = nullptr;
 
-	UPROPERTY()
-	ATantrumnGameStateBase* TantrumnGameState;
-
 	UPROPERTY()
 	UTantrumnGameWidget* TantrumnGameWidget = nullptr;
 };
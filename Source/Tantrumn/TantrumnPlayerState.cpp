@@ -13,4 +13,26 @@ void ATantrumnPlayerState::GetLifetimeReplicatedProps(TArray< FLifetimeProperty
 
 	DOREPLIFETIME_WITH_PARAMS_FAST(ATantrumnPlayerState, CurrentState, SharedParams);
 	DOREPLIFETIME_WITH_PARAMS_FAST(ATantrumnPlayerState, bIsWinner, SharedParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ATantrumnPlayerState, Match, SharedParams);
+}
+
+void ATantrumnPlayerState::SetCurrentState(EPlayerGameState PlayerGameState) {
+	if (CurrentState != PlayerGameState) {
+		CurrentState = PlayerGameState;
+		MARK_PROPERTY_DIRTY_FROM_NAME(ATantrumnPlayerState, CurrentState, this);
+	}
+}
+
+void ATantrumnPlayerState::SetIsWinner(bool IsWinner) {
+	if (bIsWinner != IsWinner) {
+		bIsWinner = IsWinner;
+		MARK_PROPERTY_DIRTY_FROM_NAME(ATantrumnPlayerState, bIsWinner, this);
+	}
+}
+
+void ATantrumnPlayerState::SetMatch(ATantrumnMatch* InMatch) {
+	if (Match != InMatch) {
+		Match = InMatch;
+		MARK_PROPERTY_DIRTY_FROM_NAME(ATantrumnPlayerState, Match, this);
+	}
 }
\ No newline at end of file
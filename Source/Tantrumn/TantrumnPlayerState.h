@@ -14,6 +14,8 @@ enum class EPlayerGameState : uint8 {
 	Finished	UMETA(DisplayName = "Finished"),
 };
 
+class ATantrumnMatch;
+
 UCLASS()
 class TANTRUMN_API ATantrumnPlayerState : public APlayerState
 {
@@ -23,12 +25,18 @@ public:
 	UFUNCTION(BlueprintPure)
 	EPlayerGameState GetCurrentState() const { return CurrentState; }
 
-	void SetCurrentState(EPlayerGameState PlayerGameState) { CurrentState = PlayerGameState; }
+	void SetCurrentState(EPlayerGameState PlayerGameState);
 
 	UFUNCTION(BlueprintPure)
 	bool IsWinner() const { return bIsWinner; }
 	
-	void SetIsWinner(bool IsWinner) { bIsWinner = IsWinner; }
+	void SetIsWinner(bool IsWinner);
+
+	// the race this player is part of, set by the game mode on the server
+	UFUNCTION(BlueprintPure)
+	ATantrumnMatch* GetMatch() const { return Match; }
+
+	void SetMatch(ATantrumnMatch* InMatch);
 
 protected:
 	UPROPERTY(ReplicatedUsing = OnRep_CurrentState)
@@ -37,6 +45,9 @@ protected:
 	UPROPERTY(replicated)
 	bool bIsWinner = false;
 
+	UPROPERTY(replicated)
+	ATantrumnMatch* Match = nullptr;
+
 	UFUNCTION()
 	virtual void OnRep_CurrentState(const EPlayerGameState& OldGameState){}
 };
@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TantrumnReplaySpectatorController.h"
+#include "Engine/DemoNetDriver.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerState.h"
+#include "GameFramework/WorldSettings.h"
+
+ATantrumnReplaySpectatorController::ATantrumnReplaySpectatorController() {
+	// keeps ticking while paused so the view can still move around the frozen match
+	bShouldPerformFullTickWhenPaused = true;
+}
+
+UDemoNetDriver* ATantrumnReplaySpectatorController::GetPlayingDemoNetDriver() const {
+	UDemoNetDriver* DemoNetDriver = GetWorld() ? GetWorld()->GetDemoNetDriver() : nullptr;
+	return DemoNetDriver && DemoNetDriver->IsPlaying() ? DemoNetDriver : nullptr;
+}
+
+void ATantrumnReplaySpectatorController::ReplaySeek(float TimeInSeconds) {
+	if (UDemoNetDriver* DemoNetDriver = GetPlayingDemoNetDriver()) {
+		DemoNetDriver->GotoTimeInSeconds(FMath::Clamp(TimeInSeconds, 0.0f, DemoNetDriver->GetDemoTotalTime()));
+	}
+}
+
+void ATantrumnReplaySpectatorController::ReplaySkip(float DeltaSeconds) {
+	ReplaySeek(GetReplayCurrentTime() + DeltaSeconds);
+}
+
+void ATantrumnReplaySpectatorController::ReplaySetPaused(bool bPaused) {
+	AWorldSettings* WorldSettings = GetWorldSettings();
+	if (!WorldSettings || !GetPlayingDemoNetDriver()) {
+		return;
+	}
+	// the demo driver stops reading frames while the world has a pauser
+	WorldSettings->SetPauserPlayerState(bPaused ? PlayerState : nullptr);
+}
+
+void ATantrumnReplaySpectatorController::ReplaySetSpeed(float Speed) {
+	AWorldSettings* WorldSettings = GetWorldSettings();
+	if (!WorldSettings || !GetPlayingDemoNetDriver()) {
+		return;
+	}
+	WorldSettings->DemoPlayTimeDilation = FMath::Clamp(Speed, MinPlaybackSpeed, MaxPlaybackSpeed);
+}
+
+bool ATantrumnReplaySpectatorController::IsReplayPaused() const {
+	const AWorldSettings* WorldSettings = GetWorldSettings();
+	return WorldSettings && WorldSettings->GetPauserPlayerState() != nullptr;
+}
+
+float ATantrumnReplaySpectatorController::GetReplayCurrentTime() const {
+	const UDemoNetDriver* DemoNetDriver = GetPlayingDemoNetDriver();
+	return DemoNetDriver ? DemoNetDriver->GetDemoCurrentTime() : 0.0f;
+}
+
+float ATantrumnReplaySpectatorController::GetReplayTotalTime() const {
+	const UDemoNetDriver* DemoNetDriver = GetPlayingDemoNetDriver();
+	return DemoNetDriver ? DemoNetDriver->GetDemoTotalTime() : 0.0f;
+}
@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/PlayerController.h"
+#include "TantrumnReplaySpectatorController.generated.h"
+
+class UDemoNetDriver;
+
+/**
+ * Controller the demo net driver spawns while a recorded match plays back with demoplay.
+ * Scrubbing jumps to the nearest checkpoint before the requested time and fast forwards from it,
+ * the exec functions make the same controls available from the console without a widget.
+ */
+UCLASS()
+class TANTRUMN_API ATantrumnReplaySpectatorController : public APlayerController
+{
+	GENERATED_BODY()
+
+public:
+	ATantrumnReplaySpectatorController();
+
+	UFUNCTION(BlueprintCallable, Exec, Category = "Replay")
+	void ReplaySeek(float TimeInSeconds);
+
+	// negative values scrub backwards
+	UFUNCTION(BlueprintCallable, Exec, Category = "Replay")
+	void ReplaySkip(float DeltaSeconds);
+
+	UFUNCTION(BlueprintCallable, Exec, Category = "Replay")
+	void ReplaySetPaused(bool bPaused);
+
+	UFUNCTION(BlueprintCallable, Exec, Category = "Replay")
+	void ReplayTogglePause() { ReplaySetPaused(!IsReplayPaused()); }
+
+	UFUNCTION(BlueprintCallable, Exec, Category = "Replay")
+	void ReplaySetSpeed(float Speed);
+
+	UFUNCTION(BlueprintPure, Category = "Replay")
+	bool IsReplayPaused() const;
+
+	UFUNCTION(BlueprintPure, Category = "Replay")
+	float GetReplayCurrentTime() const;
+
+	UFUNCTION(BlueprintPure, Category = "Replay")
+	float GetReplayTotalTime() const;
+
+protected:
+	UDemoNetDriver* GetPlayingDemoNetDriver() const;
+
+	UPROPERTY(EditAnywhere, Category = "Replay")
+	float MinPlaybackSpeed = 0.1f;
+
+	UPROPERTY(EditAnywhere, Category = "Replay")
+	float MaxPlaybackSpeed = 8.0f;
+};
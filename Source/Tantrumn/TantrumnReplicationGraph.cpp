@@ -0,0 +1,162 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TantrumnReplicationGraph.h"
+#include "ReplicationGraphTypes.h"
+#include "Engine/LevelScriptActor.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerState.h"
+#include "TantrumnCharacterBase.h"
+#include "ThrowableActor.h"
+
+void UTantrumnReplicationGraph::InitGlobalActorClassSettings() {
+	Super::InitGlobalActorClassSettings();
+
+	// replication graph is frame based, convert the legacy per actor settings for every replicated class
+	for (TObjectIterator<UClass> It; It; ++It) {
+		UClass* Class = *It;
+		AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject());
+		if (!ActorCDO || !ActorCDO->GetIsReplicated()) {
+			continue;
+		}
+
+		// skip blueprint skeleton and reinstanced classes
+		if (Class->GetName().StartsWith(TEXT("SKEL_")) || Class->GetName().StartsWith(TEXT("REINST_"))) {
+			continue;
+		}
+
+		FClassReplicationInfo ClassInfo;
+		ClassInfo.ReplicationPeriodFrame = GetReplicationPeriodFrameForFrequency(ActorCDO->NetUpdateFrequency);
+		if (ActorCDO->bAlwaysRelevant || ActorCDO->bOnlyRelevantToOwner) {
+			ClassInfo.SetCullDistanceSquared(0.0f);
+		}
+		else {
+			ClassInfo.SetCullDistanceSquared(ActorCDO->NetCullDistanceSquared);
+		}
+		GlobalActorReplicationInfoMap.SetClassInfo(Class, ClassInfo);
+	}
+}
+
+void UTantrumnReplicationGraph::InitGlobalGraphNodes() {
+	GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+	GridNode->CellSize = GridCellSize;
+	GridNode->SpatialBias = FVector2D(SpatialBiasX, SpatialBiasY);
+	AddGlobalGraphNode(GridNode);
+
+	AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+	AddGlobalGraphNode(AlwaysRelevantNode);
+
+	// gathers the player states itself and hands each connection a few of them per frame
+	PlayerStateNode = CreateNewNode<UReplicationGraphNode_PlayerStateFrequencyLimiter>();
+	PlayerStateNode->TargetActorsPerFrame = FMath::Max(PlayerStatesPerFrame, 1);
+	AddGlobalGraphNode(PlayerStateNode);
+}
+
+void UTantrumnReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) {
+	Super::InitConnectionGraphNodes(RepGraphConnection);
+
+	FTantrumnConnectionNodes Nodes;
+	Nodes.NetConnection = RepGraphConnection->NetConnection;
+
+	// adds the connection's controller, pawn and view target plus any owner only actors
+	Nodes.AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_AlwaysRelevant_ForConnection>();
+	RepGraphConnection->OnClientVisibleLevelNameAdd.AddUObject(Nodes.AlwaysRelevantNode, &UReplicationGraphNode_AlwaysRelevant_ForConnection::OnClientLevelVisibilityAdd);
+	RepGraphConnection->OnClientVisibleLevelNameRemove.AddUObject(Nodes.AlwaysRelevantNode, &UReplicationGraphNode_AlwaysRelevant_ForConnection::OnClientLevelVisibilityRemove);
+	AddConnectionGraphNode(Nodes.AlwaysRelevantNode, RepGraphConnection);
+
+	ConnectionNodes.Add(Nodes);
+}
+
+void UTantrumnReplicationGraph::RemoveClientConnection(UNetConnection* NetConnection) {
+	ConnectionNodes.RemoveAllSwap([NetConnection](const FTantrumnConnectionNodes& Nodes) { return Nodes.NetConnection == NetConnection; });
+	Super::RemoveClientConnection(NetConnection);
+}
+
+FTantrumnConnectionNodes* UTantrumnReplicationGraph::FindConnectionNodes(const UNetConnection* InNetConnection) {
+	return InNetConnection ? ConnectionNodes.FindByKey(InNetConnection) : nullptr;
+}
+
+ETantrumnClassRepPolicy UTantrumnReplicationGraph::GetClassRepPolicy(const AActor* InActor) const {
+	// player states are always relevant by default, check them before the generic flags
+	if (InActor->IsA<APlayerState>()) {
+		return ETantrumnClassRepPolicy::PlayerStates;
+	}
+	if (InActor->IsA<AGameStateBase>() || InActor->bAlwaysRelevant || InActor->IsA<ALevelScriptActor>()) {
+		return ETantrumnClassRepPolicy::RelevantAllConnections;
+	}
+	if (InActor->bOnlyRelevantToOwner) {
+		return ETantrumnClassRepPolicy::NotRouted;
+	}
+	if (InActor->IsA<ATantrumnCharacterBase>()) {
+		return ETantrumnClassRepPolicy::SpatializeDynamic;
+	}
+	// throwables and everything else sit in the grid and are only re-evaluated while awake
+	return ETantrumnClassRepPolicy::SpatializeDormancy;
+}
+
+void UTantrumnReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) {
+	switch (GetClassRepPolicy(ActorInfo.Actor)) {
+	case ETantrumnClassRepPolicy::NotRouted:
+		ActorsWithoutNetConnection.Add(ActorInfo.Actor);
+		break;
+	case ETantrumnClassRepPolicy::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+		break;
+	case ETantrumnClassRepPolicy::PlayerStates:
+		break;
+	case ETantrumnClassRepPolicy::SpatializeDynamic:
+		GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+		break;
+	case ETantrumnClassRepPolicy::SpatializeDormancy:
+		GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+		break;
+	}
+}
+
+void UTantrumnReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) {
+	switch (GetClassRepPolicy(ActorInfo.Actor)) {
+	case ETantrumnClassRepPolicy::NotRouted:
+		if (ActorsWithoutNetConnection.RemoveSwap(ActorInfo.Actor) == 0) {
+			if (FTantrumnConnectionNodes* Nodes = FindConnectionNodes(ActorInfo.Actor->GetNetConnection())) {
+				Nodes->AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+			}
+		}
+		break;
+	case ETantrumnClassRepPolicy::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+		SetActorDestructionInfoToIgnoreDistanceCulling(ActorInfo.GetActor());
+		break;
+	case ETantrumnClassRepPolicy::PlayerStates:
+		SetActorDestructionInfoToIgnoreDistanceCulling(ActorInfo.GetActor());
+		break;
+	case ETantrumnClassRepPolicy::SpatializeDynamic:
+		GridNode->RemoveActor_Dynamic(ActorInfo);
+		break;
+	case ETantrumnClassRepPolicy::SpatializeDormancy:
+		GridNode->RemoveActor_Dormancy(ActorInfo);
+		break;
+	}
+}
+
+int32 UTantrumnReplicationGraph::ServerReplicateActors(float DeltaSeconds) {
+	// owner only actors can be spawned before their owner is possessed, route them once the connection is known
+	for (int32 Index = ActorsWithoutNetConnection.Num() - 1; Index >= 0; --Index) {
+		bool bRemove = true;
+		if (AActor* Actor = ActorsWithoutNetConnection[Index]) {
+			if (UNetConnection* NetConnection = Actor->GetNetConnection()) {
+				if (FTantrumnConnectionNodes* Nodes = FindConnectionNodes(NetConnection)) {
+					Nodes->AlwaysRelevantNode->NotifyAddNetworkActor(FNewReplicatedActorInfo(Actor));
+				}
+			}
+			else {
+				bRemove = false;
+			}
+		}
+
+		if (bRemove) {
+			ActorsWithoutNetConnection.RemoveAtSwap(Index, 1, false);
+		}
+	}
+
+	return Super::ServerReplicateActors(DeltaSeconds);
+}
@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "TantrumnReplicationGraph.generated.h"
+
+class UReplicationGraphNode_ActorList;
+class UReplicationGraphNode_AlwaysRelevant_ForConnection;
+class UReplicationGraphNode_GridSpatialization2D;
+class UReplicationGraphNode_PlayerStateFrequencyLimiter;
+
+enum class ETantrumnClassRepPolicy : uint8 {
+	NotRouted,				// handled by the owning connection's always relevant node
+	RelevantAllConnections,	// game state and other bAlwaysRelevant actors
+	PlayerStates,			// collected by the global player state frequency limiter, not routed per actor
+	SpatializeDynamic,		// characters, moving every frame
+	SpatializeDormancy,		// throwables and level actors, treated as static while dormant
+};
+
+USTRUCT()
+struct FTantrumnConnectionNodes {
+	GENERATED_BODY()
+
+	UPROPERTY()
+	UNetConnection* NetConnection = nullptr;
+
+	UPROPERTY()
+	UReplicationGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantNode = nullptr;
+
+	bool operator==(const UNetConnection* InNetConnection) const { return NetConnection == InNetConnection; }
+};
+
+/**
+ * Replication graph for Tantrumn, spatializes characters and throwables so each
+ * connection only considers actors near its viewer.
+ * Enabled through ReplicationDriverClassName in DefaultEngine.ini.
+ */
+UCLASS(transient, config = Engine)
+class TANTRUMN_API UTantrumnReplicationGraph : public UReplicationGraph
+{
+	GENERATED_BODY()
+
+public:
+	virtual void InitGlobalActorClassSettings() override;
+	virtual void InitGlobalGraphNodes() override;
+	virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+	virtual void RemoveClientConnection(UNetConnection* NetConnection) override;
+	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+	virtual int32 ServerReplicateActors(float DeltaSeconds) override;
+
+protected:
+	ETantrumnClassRepPolicy GetClassRepPolicy(const AActor* InActor) const;
+
+	FTantrumnConnectionNodes* FindConnectionNodes(const UNetConnection* InNetConnection);
+
+	UPROPERTY(config)
+	float GridCellSize = 10000.0f;
+
+	UPROPERTY(config)
+	float SpatialBiasX = -WORLD_MAX;
+
+	UPROPERTY(config)
+	float SpatialBiasY = -WORLD_MAX;
+
+	// player states sent to each connection per replication frame, the rest wait for later frames
+	UPROPERTY(config)
+	int32 PlayerStatesPerFrame = 2;
+
+	UPROPERTY()
+	UReplicationGraphNode_GridSpatialization2D* GridNode = nullptr;
+
+	UPROPERTY()
+	UReplicationGraphNode_ActorList* AlwaysRelevantNode = nullptr;
+
+	// one node for every connection, the cost grows with players rather than players squared
+	UPROPERTY()
+	UReplicationGraphNode_PlayerStateFrequencyLimiter* PlayerStateNode = nullptr;
+
+	UPROPERTY()
+	TArray<FTantrumnConnectionNodes> ConnectionNodes;
+
+	// owner only actors waiting for their net connection to be set before they can be routed
+	UPROPERTY()
+	TArray<AActor*> ActorsWithoutNetConnection;
+};
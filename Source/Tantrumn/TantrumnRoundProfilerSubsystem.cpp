@@ -0,0 +1,148 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TantrumnRoundProfilerSubsystem.h"
+#include "Tantrumn.h"
+#include "TantrumnMatch.h"
+#include "Containers/Ticker.h"
+#include "Dom/JsonObject.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogTantrumnProfile, Log, All)
+
+bool UTantrumnRoundProfilerSubsystem::bRoundCaptureEnabled = false;
+
+static FAutoConsoleCommandWithWorldAndArgs RoundCaptureCommand(
+	TEXT("Tantrumn.Profile.RoundCapture"),
+	TEXT("start: capture every round from the next match start, stop: finish the current round and stop capturing"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World) {
+		if (Args.Num() == 0 || (Args[0] != TEXT("start") && Args[0] != TEXT("stop"))) {
+			UE_LOG(LogTantrumnProfile, Display, TEXT("Usage: Tantrumn.Profile.RoundCapture start|stop, currently %s"), UTantrumnRoundProfilerSubsystem::IsRoundCaptureEnabled() ? TEXT("started") : TEXT("stopped"));
+			return;
+		}
+
+		const bool bEnable = Args[0] == TEXT("start");
+		UTantrumnRoundProfilerSubsystem::SetRoundCaptureEnabled(bEnable);
+		UTantrumnRoundProfilerSubsystem* RoundProfiler = World ? World->GetSubsystem<UTantrumnRoundProfilerSubsystem>() : nullptr;
+		if (!bEnable && RoundProfiler && RoundProfiler->IsCapturingRound()) {
+			RoundProfiler->EndRound(nullptr);
+		}
+	})
+);
+
+void UTantrumnRoundProfilerSubsystem::Deinitialize() {
+	// travelling mid round still writes what was captured
+	if (IsCapturingRound()) {
+		EndRound(nullptr);
+	}
+	Super::Deinitialize();
+}
+
+void UTantrumnRoundProfilerSubsystem::BeginRound(const ATantrumnMatch* Match) {
+	if (!bRoundCaptureEnabled || IsCapturingRound() || !Match) {
+		return;
+	}
+
+	RoundMatchId = Match->GetMatchId();
+	RoundStartTime = FDateTime::Now();
+	RoundStartSeconds = FPlatformTime::Seconds();
+	FrameTimesMs.Reset();
+	NumThrows = 0;
+	GetNetTotalBytes(StartInBytes, StartOutBytes);
+
+#if CSV_PROFILER
+	if (!FCsvProfiler::Get()->IsCapturing()) {
+		const FString Filename = FString::Printf(TEXT("Tantrumn_Match%d_%s.csv"), RoundMatchId, *RoundStartTime.ToString());
+		FCsvProfiler::Get()->BeginCapture(-1, FPaths::ProfilingDir() / TEXT("CSV"), Filename);
+		bStartedCsvCapture = true;
+	}
+#endif
+	CSV_EVENT(Tantrumn, TEXT("RoundBegin Match%d"), RoundMatchId);
+
+	FrameTickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UTantrumnRoundProfilerSubsystem::SampleFrame));
+	UE_LOG(LogTantrumnProfile, Display, TEXT("Round capture started for match %d"), RoundMatchId);
+}
+
+void UTantrumnRoundProfilerSubsystem::EndRound(const ATantrumnMatch* Match) {
+	// null ends whatever round is running
+	if (!IsCapturingRound() || (Match && Match->GetMatchId() != RoundMatchId)) {
+		return;
+	}
+
+	FTicker::GetCoreTicker().RemoveTicker(FrameTickerHandle);
+	FrameTickerHandle.Reset();
+	GetNetTotalBytes(EndInBytes, EndOutBytes);
+	CSV_EVENT(Tantrumn, TEXT("RoundEnd Match%d"), RoundMatchId);
+
+#if CSV_PROFILER
+	if (bStartedCsvCapture) {
+		FCsvProfiler::Get()->EndCapture();
+		bStartedCsvCapture = false;
+	}
+#endif
+
+	WriteSummary(FString::Printf(TEXT("Tantrumn_Match%d_%s"), RoundMatchId, *RoundStartTime.ToString()));
+	RoundMatchId = INDEX_NONE;
+}
+
+bool UTantrumnRoundProfilerSubsystem::SampleFrame(float DeltaTime) {
+	FrameTimesMs.Add((float)(FApp::GetDeltaTime() * 1000.0));
+	return true;
+}
+
+void UTantrumnRoundProfilerSubsystem::GetNetTotalBytes(uint64& OutInBytes, uint64& OutOutBytes) const {
+	const UNetDriver* NetDriver = GetWorld() ? GetWorld()->GetNetDriver() : nullptr;
+	OutInBytes = NetDriver ? NetDriver->InTotalBytes : 0;
+	OutOutBytes = NetDriver ? NetDriver->OutTotalBytes : 0;
+}
+
+static float GetPercentile(const TArray<float>& SortedValues, float Percentile) {
+	if (SortedValues.Num() == 0) {
+		return 0.0f;
+	}
+	const int32 Index = FMath::Clamp(FMath::CeilToInt(Percentile * SortedValues.Num()) - 1, 0, SortedValues.Num() - 1);
+	return SortedValues[Index];
+}
+
+void UTantrumnRoundProfilerSubsystem::WriteSummary(const FString& BaseFilename) const {
+	TArray<float> SortedFrameTimesMs = FrameTimesMs;
+	SortedFrameTimesMs.Sort();
+
+	float TotalFrameTimeMs = 0.0f;
+	for (float FrameTimeMs : SortedFrameTimesMs) {
+		TotalFrameTimeMs += FrameTimeMs;
+	}
+
+	TSharedRef<FJsonObject> Summary = MakeShared<FJsonObject>();
+	Summary->SetNumberField(TEXT("matchId"), RoundMatchId);
+	Summary->SetStringField(TEXT("startTime"), RoundStartTime.ToIso8601());
+	Summary->SetNumberField(TEXT("durationSeconds"), FPlatformTime::Seconds() - RoundStartSeconds);
+	Summary->SetNumberField(TEXT("frames"), SortedFrameTimesMs.Num());
+	Summary->SetNumberField(TEXT("frameTimeAvgMs"), SortedFrameTimesMs.Num() > 0 ? TotalFrameTimeMs / SortedFrameTimesMs.Num() : 0.0f);
+	Summary->SetNumberField(TEXT("frameTimeP50Ms"), GetPercentile(SortedFrameTimesMs, 0.5f));
+	Summary->SetNumberField(TEXT("frameTimeP90Ms"), GetPercentile(SortedFrameTimesMs, 0.9f));
+	Summary->SetNumberField(TEXT("frameTimeP99Ms"), GetPercentile(SortedFrameTimesMs, 0.99f));
+	Summary->SetNumberField(TEXT("frameTimeMaxMs"), SortedFrameTimesMs.Num() > 0 ? SortedFrameTimesMs.Last() : 0.0f);
+	Summary->SetNumberField(TEXT("netInBytes"), (double)(EndInBytes - StartInBytes));
+	Summary->SetNumberField(TEXT("netOutBytes"), (double)(EndOutBytes - StartOutBytes));
+	Summary->SetNumberField(TEXT("throws"), NumThrows);
+
+	FString SummaryString;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&SummaryString);
+	FJsonSerializer::Serialize(Summary, Writer);
+
+	const FString SummaryPath = FPaths::ProfilingDir() / TEXT("Tantrumn") / (BaseFilename + TEXT(".json"));
+	if (FFileHelper::SaveStringToFile(SummaryString, *SummaryPath)) {
+		UE_LOG(LogTantrumnProfile, Display, TEXT("Round summary written to %s"), *SummaryPath);
+	}
+	else {
+		UE_LOG(LogTantrumnProfile, Warning, TEXT("Failed to write round summary to %s"), *SummaryPath);
+	}
+}
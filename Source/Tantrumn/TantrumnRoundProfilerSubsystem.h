@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TantrumnRoundProfilerSubsystem.generated.h"
+
+class ATantrumnMatch;
+
+/**
+ * Captures one round at a time while round capture is enabled with Tantrumn.Profile.RoundCapture.
+ * A round runs from a match starting to play until it ends or restarts. Each round gets its own
+ * CSV profiler capture and a json summary of frame times, net bytes and throws.
+ */
+UCLASS()
+class TANTRUMN_API UTantrumnRoundProfilerSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// driven by the match state, a new round only starts once the previous one has ended
+	void BeginRound(const ATantrumnMatch* Match);
+	void EndRound(const ATantrumnMatch* Match);
+
+	void NotifyThrow() { ++NumThrows; }
+
+	bool IsCapturingRound() const { return RoundMatchId != INDEX_NONE; }
+
+	static bool IsRoundCaptureEnabled() { return bRoundCaptureEnabled; }
+	static void SetRoundCaptureEnabled(bool bEnabled) { bRoundCaptureEnabled = bEnabled; }
+
+protected:
+	bool SampleFrame(float DeltaTime);
+	void WriteSummary(const FString& BaseFilename) const;
+
+	void GetNetTotalBytes(uint64& OutInBytes, uint64& OutOutBytes) const;
+
+	static bool bRoundCaptureEnabled;
+
+	int32 RoundMatchId = INDEX_NONE;
+	FDateTime RoundStartTime;
+	double RoundStartSeconds = 0.0;
+
+	TArray<float> FrameTimesMs;
+	uint64 StartInBytes = 0;
+	uint64 StartOutBytes = 0;
+	uint64 EndInBytes = 0;
+	uint64 EndOutBytes = 0;
+	int32 NumThrows = 0;
+
+	// only captures this subsystem started are stopped by it
+	bool bStartedCsvCapture = false;
+
+	FDelegateHandle FrameTickerHandle;
+};
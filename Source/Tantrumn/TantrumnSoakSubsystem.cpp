@@ -0,0 +1,303 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TantrumnSoakSubsystem.h"
+#include "EngineUtils.h"
+#include "TantrumnAIController.h"
+#include "TantrumnCharacterBase.h"
+#include "TantrumnGameModeBase.h"
+#include "TantrumnMatch.h"
+#include "TantrumnThrowMetricsSubsystem.h"
+#include "Containers/Ticker.h"
+#include "Dom/JsonObject.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "TimerManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogTantrumnSoak, Log, All)
+
+void FTantrumnPhysicsTimingTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) {
+	if (Target) {
+		Target->OnPhysicsTimingTick(bIsStart);
+	}
+}
+
+FString FTantrumnPhysicsTimingTickFunction::DiagnosticMessage() {
+	return bIsStart ? TEXT("FTantrumnPhysicsTimingTickFunction Start") : TEXT("FTantrumnPhysicsTimingTickFunction End");
+}
+
+bool UTantrumnSoakSubsystem::ShouldCreateSubsystem(UObject* Outer) const {
+	return FParse::Param(FCommandLine::Get(), TEXT("TantrumnSoak")) && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UTantrumnSoakSubsystem::Deinitialize() {
+	FTicker::GetCoreTicker().RemoveTicker(FrameTickerHandle);
+	PhysicsStartTickFunction.UnRegisterTickFunction();
+	PhysicsEndTickFunction.UnRegisterTickFunction();
+	Super::Deinitialize();
+}
+
+void UTantrumnSoakSubsystem::BeginSoak(ATantrumnGameModeBase* InGameMode) {
+	UWorld* World = GetWorld();
+	if (!InGameMode || !World->IsGameWorld() || GameMode) {
+		return;
+	}
+	GameMode = InGameMode;
+
+	FParse::Value(FCommandLine::Get(), TEXT("SoakBots="), NumBots);
+	FParse::Value(FCommandLine::Get(), TEXT("SoakRounds="), NumRounds);
+	FParse::Value(FCommandLine::Get(), TEXT("SoakRoundTimeout="), RoundTimeout);
+	FParse::Value(FCommandLine::Get(), TEXT("SoakClients="), NumClients);
+	FParse::Value(FCommandLine::Get(), TEXT("SoakClientTimeout="), ClientWaitTimeout);
+	if (!FParse::Value(FCommandLine::Get(), TEXT("SoakOutput="), OutputPath)) {
+		OutputPath = FPaths::ProfilingDir() / TEXT("Tantrumn") / FString::Printf(TEXT("Soak_%s.json"), *FDateTime::Now().ToString());
+	}
+
+	// physics runs from StartPhysics until EndPhysics completes, the span between the two markers times it
+	PhysicsStartTickFunction.Target = this;
+	PhysicsStartTickFunction.bIsStart = true;
+	PhysicsStartTickFunction.bCanEverTick = true;
+	PhysicsStartTickFunction.TickGroup = TG_StartPhysics;
+	PhysicsStartTickFunction.RegisterTickFunction(World->PersistentLevel);
+	PhysicsEndTickFunction.Target = this;
+	PhysicsEndTickFunction.bCanEverTick = true;
+	PhysicsEndTickFunction.TickGroup = TG_PostPhysics;
+	PhysicsEndTickFunction.RegisterTickFunction(World->PersistentLevel);
+
+	FrameTickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UTantrumnSoakSubsystem::SampleFrame));
+
+	SpawnBots();
+	UE_LOG(LogTantrumnSoak, Display, TEXT("Soak starting with %d bots for %d rounds"), NumBots, NumRounds);
+
+	// give the behavior trees a moment to start before the first countdown, and the clients time to connect
+	ClientWaitStartSeconds = FPlatformTime::Seconds();
+	World->GetTimerManager().SetTimer(RoundTimerHandle, this, &UTantrumnSoakSubsystem::WaitForClients, 0.5f, true, 1.0f);
+}
+
+int32 UTantrumnSoakSubsystem::GetNumClientConnections() const {
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	return NetDriver ? NetDriver->ClientConnections.Num() : 0;
+}
+
+void UTantrumnSoakSubsystem::WaitForClients() {
+	const int32 NumConnected = GetNumClientConnections();
+	if (NumConnected < NumClients) {
+		if (FPlatformTime::Seconds() - ClientWaitStartSeconds < ClientWaitTimeout) {
+			return;
+		}
+		UE_LOG(LogTantrumnSoak, Warning, TEXT("Only %d of %d soak clients connected, starting anyway"), NumConnected, NumClients);
+	}
+	StartRound();
+}
+
+void UTantrumnSoakSubsystem::SpawnBots() {
+	// bots placed in the map are the template, extra ones are copies spread out beside them
+	TArray<ATantrumnCharacterBase*> PlacedBots;
+	for (TActorIterator<ATantrumnCharacterBase> It(GetWorld()); It; ++It) {
+		if (It->GetController<ATantrumnAIController>()) {
+			PlacedBots.Add(*It);
+		}
+	}
+	if (PlacedBots.Num() == 0) {
+		UE_LOG(LogTantrumnSoak, Warning, TEXT("No AI controlled characters in the map to copy, running with none"));
+		return;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+	const float Spacing = 150.0f;
+	for (int32 BotIndex = PlacedBots.Num(); BotIndex < NumBots; ++BotIndex) {
+		const ATantrumnCharacterBase* Template = PlacedBots[BotIndex % PlacedBots.Num()];
+		// alternate sides of the template, one lane further out every second copy
+		const int32 Row = BotIndex / PlacedBots.Num();
+		const float Side = (Row % 2) ? 1.0f : -1.0f;
+		const FVector Location = Template->GetActorLocation() + Template->GetActorRightVector() * Spacing * ((Row + 1) / 2) * Side;
+		APawn* Bot = GetWorld()->SpawnActor<APawn>(Template->GetClass(), Location, Template->GetActorRotation(), SpawnParams);
+		if (Bot && !Bot->GetController()) {
+			Bot->SpawnDefaultController();
+		}
+	}
+}
+
+void UTantrumnSoakSubsystem::StartRound() {
+	CurrentRound = FTantrumnSoakRound();
+	CurrentRound.NumClients = GetNumClientConnections();
+	bRoundRunning = true;
+	RoundStartSeconds = FPlatformTime::Seconds();
+	GetNetTotalBytes(RoundStartInBytes, RoundStartOutBytes);
+	if (UTantrumnThrowMetricsSubsystem* ThrowMetrics = GetWorld()->GetSubsystem<UTantrumnThrowMetricsSubsystem>()) {
+		ThrowMetrics->ResetSamples();
+	}
+
+	GameMode->StartMatchesWithoutPlayers();
+	GetWorld()->GetTimerManager().SetTimer(RoundTimerHandle, this, &UTantrumnSoakSubsystem::CheckRound, 0.5f, true);
+}
+
+void UTantrumnSoakSubsystem::CheckRound() {
+	bool bAllOver = true;
+	for (const ATantrumnMatch* Match : GameMode->GetMatches()) {
+		if (Match->GetPlayers().Num() > 0 && Match->GetMatchState() != EGameState::GameOver) {
+			bAllOver = false;
+			break;
+		}
+	}
+
+	const bool bTimedOut = RoundTimeout > 0.0f && FPlatformTime::Seconds() - RoundStartSeconds > RoundTimeout;
+	if (bAllOver || bTimedOut) {
+		EndRound(!bAllOver);
+	}
+}
+
+void UTantrumnSoakSubsystem::EndRound(bool bTimedOut) {
+	GetWorld()->GetTimerManager().ClearTimer(RoundTimerHandle);
+	bRoundRunning = false;
+
+	CurrentRound.DurationSeconds = FPlatformTime::Seconds() - RoundStartSeconds;
+	CurrentRound.bTimedOut = bTimedOut;
+	uint64 InBytes = 0;
+	uint64 OutBytes = 0;
+	GetNetTotalBytes(InBytes, OutBytes);
+	CurrentRound.NetInBytes = InBytes - RoundStartInBytes;
+	CurrentRound.NetOutBytes = OutBytes - RoundStartOutBytes;
+	if (const UTantrumnThrowMetricsSubsystem* ThrowMetrics = GetWorld()->GetSubsystem<UTantrumnThrowMetricsSubsystem>()) {
+		CurrentRound.AttachSeconds = ThrowMetrics->GetAttachTimes();
+		CurrentRound.ThrowLatencySeconds = ThrowMetrics->GetThrowLatencies();
+		CurrentRound.NumStuckStates = ThrowMetrics->GetNumStuckStates();
+		CurrentRound.NumOverBudget = ThrowMetrics->GetNumOverBudget();
+	}
+	Rounds.Add(MoveTemp(CurrentRound));
+	UE_LOG(LogTantrumnSoak, Display, TEXT("Soak round %d/%d finished in %.1fs%s"), Rounds.Num(), NumRounds, Rounds.Last().DurationSeconds, bTimedOut ? TEXT(" (timed out)") : TEXT(""));
+
+	if (Rounds.Num() >= NumRounds) {
+		WriteResults();
+		FPlatformMisc::RequestExit(false);
+		return;
+	}
+
+	for (ATantrumnMatch* Match : GameMode->GetMatches()) {
+		GameMode->RestartGame(Match);
+	}
+	StartRound();
+}
+
+bool UTantrumnSoakSubsystem::SampleFrame(float DeltaTime) {
+	if (bRoundRunning) {
+		CurrentRound.GameThreadMs.Add(FPlatformTime::ToMilliseconds(GGameThreadTime));
+	}
+	return true;
+}
+
+void UTantrumnSoakSubsystem::OnPhysicsTimingTick(bool bIsStart) {
+	if (bIsStart) {
+		PhysicsStartSeconds = FPlatformTime::Seconds();
+	}
+	else if (bRoundRunning && PhysicsStartSeconds > 0.0) {
+		CurrentRound.PhysicsMs.Add((float)((FPlatformTime::Seconds() - PhysicsStartSeconds) * 1000.0));
+	}
+}
+
+void UTantrumnSoakSubsystem::GetNetTotalBytes(uint64& OutInBytes, uint64& OutOutBytes) const {
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	OutInBytes = NetDriver ? NetDriver->InTotalBytes : 0;
+	OutOutBytes = NetDriver ? NetDriver->OutTotalBytes : 0;
+}
+
+static TSharedRef<FJsonObject> MakeTimingJson(TArray<float> Samples) {
+	TSharedRef<FJsonObject> Timing = MakeShared<FJsonObject>();
+	Samples.Sort();
+	float Total = 0.0f;
+	for (float Sample : Samples) {
+		Total += Sample;
+	}
+	const auto Percentile = [&Samples](float InPercentile) {
+		return Samples.Num() > 0 ? Samples[FMath::Clamp(FMath::CeilToInt(InPercentile * Samples.Num()) - 1, 0, Samples.Num() - 1)] : 0.0f;
+	};
+	Timing->SetNumberField(TEXT("avg"), Samples.Num() > 0 ? Total / Samples.Num() : 0.0f);
+	Timing->SetNumberField(TEXT("p50"), Percentile(0.5f));
+	Timing->SetNumberField(TEXT("p95"), Percentile(0.95f));
+	Timing->SetNumberField(TEXT("max"), Samples.Num() > 0 ? Samples.Last() : 0.0f);
+	return Timing;
+}
+
+void UTantrumnSoakSubsystem::WriteResults() const {
+	TArray<float> AllGameThreadMs;
+	TArray<float> AllPhysicsMs;
+	double NetDuration = 0.0;
+	uint64 TotalInBytes = 0;
+	uint64 TotalOutBytes = 0;
+	TArray<float> AllAttachSeconds;
+	TArray<float> AllThrowLatencySeconds;
+	int32 TotalStuckStates = 0;
+	int32 TotalOverBudget = 0;
+
+	TArray<TSharedPtr<FJsonValue>> RoundValues;
+	for (const FTantrumnSoakRound& Round : Rounds) {
+		TSharedRef<FJsonObject> RoundJson = MakeShared<FJsonObject>();
+		RoundJson->SetNumberField(TEXT("durationSeconds"), Round.DurationSeconds);
+		RoundJson->SetBoolField(TEXT("timedOut"), Round.bTimedOut);
+		RoundJson->SetObjectField(TEXT("gameThreadMs"), MakeTimingJson(Round.GameThreadMs));
+		RoundJson->SetObjectField(TEXT("physicsMs"), MakeTimingJson(Round.PhysicsMs));
+		// without a remote connection the driver moves next to nothing, leave the figures out rather than report zero
+		RoundJson->SetNumberField(TEXT("clients"), Round.NumClients);
+		if (Round.NumClients > 0) {
+			RoundJson->SetNumberField(TEXT("netInBytesPerSecond"), Round.DurationSeconds > 0.0 ? Round.NetInBytes / Round.DurationSeconds : 0.0);
+			RoundJson->SetNumberField(TEXT("netOutBytesPerSecond"), Round.DurationSeconds > 0.0 ? Round.NetOutBytes / Round.DurationSeconds : 0.0);
+		}
+		RoundJson->SetObjectField(TEXT("attachSeconds"), MakeTimingJson(Round.AttachSeconds));
+		RoundJson->SetObjectField(TEXT("throwLatencySeconds"), MakeTimingJson(Round.ThrowLatencySeconds));
+		RoundJson->SetNumberField(TEXT("stuckStates"), Round.NumStuckStates);
+		RoundJson->SetNumberField(TEXT("overBudget"), Round.NumOverBudget);
+		RoundValues.Add(MakeShared<FJsonValueObject>(RoundJson));
+
+		AllAttachSeconds.Append(Round.AttachSeconds);
+		AllThrowLatencySeconds.Append(Round.ThrowLatencySeconds);
+		TotalStuckStates += Round.NumStuckStates;
+		TotalOverBudget += Round.NumOverBudget;
+
+		AllGameThreadMs.Append(Round.GameThreadMs);
+		AllPhysicsMs.Append(Round.PhysicsMs);
+		if (Round.NumClients > 0) {
+			NetDuration += Round.DurationSeconds;
+			TotalInBytes += Round.NetInBytes;
+			TotalOutBytes += Round.NetOutBytes;
+		}
+	}
+
+	TSharedRef<FJsonObject> Results = MakeShared<FJsonObject>();
+	Results->SetStringField(TEXT("map"), UWorld::RemovePIEPrefix(GetWorld()->GetOutermost()->GetName()));
+	Results->SetStringField(TEXT("build"), FApp::GetBuildVersion());
+	Results->SetStringField(TEXT("configuration"), LexToString(FApp::GetBuildConfiguration()));
+	Results->SetNumberField(TEXT("bots"), NumBots);
+	Results->SetNumberField(TEXT("rounds"), Rounds.Num());
+	Results->SetObjectField(TEXT("gameThreadMs"), MakeTimingJson(AllGameThreadMs));
+	Results->SetObjectField(TEXT("physicsMs"), MakeTimingJson(AllPhysicsMs));
+	Results->SetNumberField(TEXT("memoryPeakUsedMB"), FPlatformMemory::GetStats().PeakUsedPhysical / (1024.0 * 1024.0));
+	Results->SetNumberField(TEXT("clients"), NumClients);
+	if (NetDuration > 0.0) {
+		Results->SetNumberField(TEXT("netInBytesPerSecond"), TotalInBytes / NetDuration);
+		Results->SetNumberField(TEXT("netOutBytesPerSecond"), TotalOutBytes / NetDuration);
+	}
+	Results->SetObjectField(TEXT("attachSeconds"), MakeTimingJson(AllAttachSeconds));
+	Results->SetObjectField(TEXT("throwLatencySeconds"), MakeTimingJson(AllThrowLatencySeconds));
+	Results->SetNumberField(TEXT("stuckStates"), TotalStuckStates);
+	Results->SetNumberField(TEXT("overBudget"), TotalOverBudget);
+	Results->SetArrayField(TEXT("roundResults"), RoundValues);
+
+	FString ResultsString;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&ResultsString);
+	FJsonSerializer::Serialize(Results, Writer);
+
+	if (FFileHelper::SaveStringToFile(ResultsString, *OutputPath)) {
+		UE_LOG(LogTantrumnSoak, Display, TEXT("Soak results written to %s"), *OutputPath);
+	}
+	else {
+		UE_LOG(LogTantrumnSoak, Error, TEXT("Failed to write soak results to %s"), *OutputPath);
+	}
+}
@@ -0,0 +1,105 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TantrumnSoakSubsystem.generated.h"
+
+class ATantrumnGameModeBase;
+class UTantrumnSoakSubsystem;
+
+// marks the start or end of the physics part of the frame for the soak timings
+USTRUCT()
+struct FTantrumnPhysicsTimingTickFunction : public FTickFunction {
+	GENERATED_BODY()
+
+	UTantrumnSoakSubsystem* Target = nullptr;
+	bool bIsStart = false;
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FTantrumnPhysicsTimingTickFunction> : public TStructOpsTypeTraitsBase2<FTantrumnPhysicsTimingTickFunction> {
+	enum {
+		WithCopy = false
+	};
+};
+
+// what one soak round measured
+struct FTantrumnSoakRound {
+	double DurationSeconds = 0.0;
+	bool bTimedOut = false;
+	// remote connections during the round, net figures only mean something with at least one
+	int32 NumClients = 0;
+	TArray<float> GameThreadMs;
+	TArray<float> PhysicsMs;
+	uint64 NetInBytes = 0;
+	uint64 NetOutBytes = 0;
+	TArray<float> AttachSeconds;
+	TArray<float> ThrowLatencySeconds;
+	int32 NumStuckStates = 0;
+	int32 NumOverBudget = 0;
+};
+
+/**
+ * Bot driven benchmark, only created when the game is launched with -TantrumnSoak.
+ * Fills the map up to -SoakBots= bots, runs -SoakRounds= races from countdown to game over
+ * and writes the game thread, physics, memory and bandwidth figures as json to -SoakOutput=
+ * before exiting. Rounds wait for -SoakClients= remote connections, LaunchSoak.sh starts a headless
+ * spectator client so the bandwidth comes from a real connection.
+ */
+UCLASS()
+class TANTRUMN_API UTantrumnSoakSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	// called by the game mode once its matches exist
+	void BeginSoak(ATantrumnGameModeBase* InGameMode);
+
+	void OnPhysicsTimingTick(bool bIsStart);
+
+protected:
+	void SpawnBots();
+	void WaitForClients();
+	int32 GetNumClientConnections() const;
+	void StartRound();
+	void CheckRound();
+	void EndRound(bool bTimedOut);
+	void WriteResults() const;
+
+	bool SampleFrame(float DeltaTime);
+	void GetNetTotalBytes(uint64& OutInBytes, uint64& OutOutBytes) const;
+
+	UPROPERTY()
+	ATantrumnGameModeBase* GameMode = nullptr;
+
+	int32 NumBots = 8;
+	int32 NumRounds = 5;
+	float RoundTimeout = 300.0f;
+	int32 NumClients = 0;
+	float ClientWaitTimeout = 60.0f;
+	double ClientWaitStartSeconds = 0.0;
+	FString OutputPath;
+
+	TArray<FTantrumnSoakRound> Rounds;
+	FTantrumnSoakRound CurrentRound;
+	bool bRoundRunning = false;
+	double RoundStartSeconds = 0.0;
+	uint64 RoundStartInBytes = 0;
+	uint64 RoundStartOutBytes = 0;
+
+	FTantrumnPhysicsTimingTickFunction PhysicsStartTickFunction;
+	FTantrumnPhysicsTimingTickFunction PhysicsEndTickFunction;
+	double PhysicsStartSeconds = 0.0;
+
+	FDelegateHandle FrameTickerHandle;
+	FTimerHandle RoundTimerHandle;
+};
@@ -0,0 +1,220 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TantrumnStatusEffectComponent.h"
+#include "GameFramework/GameStateBase.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+
+static FTantrumnAttributeModifier MakeModifier(ETantrumnAttribute Attribute, ETantrumnModifierOp Operation, float Magnitude) {
+	FTantrumnAttributeModifier Modifier;
+	Modifier.Attribute = Attribute;
+	Modifier.Operation = Operation;
+	Modifier.Magnitude = Magnitude;
+	return Modifier;
+}
+
+UTantrumnStatusEffectComponent::UTantrumnStatusEffectComponent() {
+	PrimaryComponentTick.bCanEverTick = false;
+	SetIsReplicatedByDefault(true);
+
+	for (uint8 Index = 0; Index < (uint8)ETantrumnAttribute::Count; ++Index) {
+		BaseValues[Index] = 0.0f;
+		CurrentValues[Index] = 0.0f;
+	}
+	BaseValues[(uint8)ETantrumnAttribute::ThrowPower] = 1.0f;
+	CurrentValues[(uint8)ETantrumnAttribute::ThrowPower] = 1.0f;
+
+	UTantrumnEffectDefinition* SpeedEffect = CreateDefaultSubobject<UTantrumnEffectDefinition>(TEXT("DefaultSpeedEffect"));
+	SpeedEffect->BuffModifiers.Add(MakeModifier(ETantrumnAttribute::SprintSpeed, ETantrumnModifierOp::Multiply, 2.0f));
+	SpeedEffect->DebuffModifiers.Add(MakeModifier(ETantrumnAttribute::WalkSpeed, ETantrumnModifierOp::Multiply, 0.0f));
+	SpeedEffect->DebuffModifiers.Add(MakeModifier(ETantrumnAttribute::SprintSpeed, ETantrumnModifierOp::Multiply, 0.0f));
+	// the debuff used to disable movement outright, so a slowed character can't jump either
+	SpeedEffect->DebuffModifiers.Add(MakeModifier(ETantrumnAttribute::JumpZVelocity, ETantrumnModifierOp::Multiply, 0.0f));
+	EffectDefinitions.Add(EEffectType::Speed, SpeedEffect);
+
+	UTantrumnEffectDefinition* JumpEffect = CreateDefaultSubobject<UTantrumnEffectDefinition>(TEXT("DefaultJumpEffect"));
+	JumpEffect->BuffModifiers.Add(MakeModifier(ETantrumnAttribute::JumpZVelocity, ETantrumnModifierOp::Multiply, 1.5f));
+	JumpEffect->DebuffModifiers.Add(MakeModifier(ETantrumnAttribute::JumpZVelocity, ETantrumnModifierOp::Multiply, 0.0f));
+	EffectDefinitions.Add(EEffectType::Jump, JumpEffect);
+
+	UTantrumnEffectDefinition* PowerEffect = CreateDefaultSubobject<UTantrumnEffectDefinition>(TEXT("DefaultPowerEffect"));
+	PowerEffect->BuffModifiers.Add(MakeModifier(ETantrumnAttribute::ThrowSpeed, ETantrumnModifierOp::Multiply, 1.5f));
+	PowerEffect->BuffModifiers.Add(MakeModifier(ETantrumnAttribute::ThrowPower, ETantrumnModifierOp::Multiply, 2.0f));
+	PowerEffect->DebuffModifiers.Add(MakeModifier(ETantrumnAttribute::ThrowSpeed, ETantrumnModifierOp::Multiply, 0.5f));
+	PowerEffect->DebuffModifiers.Add(MakeModifier(ETantrumnAttribute::ThrowPower, ETantrumnModifierOp::Multiply, 0.5f));
+	EffectDefinitions.Add(EEffectType::Power, PowerEffect);
+}
+
+void UTantrumnStatusEffectComponent::GetLifetimeReplicatedProps(TArray< FLifetimeProperty >& OutLifetimeProps) const {
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams SharedParams;
+	SharedParams.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(UTantrumnStatusEffectComponent, ActiveEffects, SharedParams);
+}
+
+const UTantrumnEffectDefinition* UTantrumnStatusEffectComponent::GetDefinition(EEffectType EffectType) const {
+	UTantrumnEffectDefinition* const* Definition = EffectDefinitions.Find(EffectType);
+	return Definition ? *Definition : nullptr;
+}
+
+float UTantrumnStatusEffectComponent::GetServerWorldTime() const {
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	return GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+}
+
+bool UTantrumnStatusEffectComponent::IsEffectActive(const FTantrumnActiveEffect& ActiveEffect) const {
+	return ActiveEffect.StackCount > 0 && ActiveEffect.EndTime > GetServerWorldTime();
+}
+
+void UTantrumnStatusEffectComponent::ApplyEffect(EEffectType EffectType, bool bIsBuff) {
+	const UTantrumnEffectDefinition* Definition = GetDefinition(EffectType);
+	if (!GetOwner()->HasAuthority() || !Definition) {
+		return;
+	}
+
+	ActiveEffects.RemoveAll([this](const FTantrumnActiveEffect& ActiveEffect) { return !IsEffectActive(ActiveEffect); });
+
+	FTantrumnActiveEffect* ActiveEffect = ActiveEffects.FindByPredicate([EffectType, bIsBuff](const FTantrumnActiveEffect& InActiveEffect) {
+		return InActiveEffect.EffectType == EffectType && InActiveEffect.bIsBuff == bIsBuff;
+	});
+	if (!ActiveEffect) {
+		ActiveEffect = &ActiveEffects.AddDefaulted_GetRef();
+		ActiveEffect->EffectType = EffectType;
+		ActiveEffect->bIsBuff = bIsBuff;
+	}
+
+	const uint8 MaxStacks = Definition->StackPolicy == ETantrumnEffectStackPolicy::Stack ? FMath::Max<uint8>(Definition->MaxStacks, 1) : 1;
+	ActiveEffect->StackCount = FMath::Min<uint8>(ActiveEffect->StackCount + 1, MaxStacks);
+	ActiveEffect->EndTime = GetServerWorldTime() + Definition->Duration;
+	MARK_PROPERTY_DIRTY_FROM_NAME(UTantrumnStatusEffectComponent, ActiveEffects, this);
+
+	UpdateAppliedEffects();
+}
+
+void UTantrumnStatusEffectComponent::ClearEffects() {
+	if (!GetOwner()->HasAuthority() || ActiveEffects.Num() == 0) {
+		return;
+	}
+	ActiveEffects.Reset();
+	MARK_PROPERTY_DIRTY_FROM_NAME(UTantrumnStatusEffectComponent, ActiveEffects, this);
+	UpdateAppliedEffects();
+}
+
+int32 UTantrumnStatusEffectComponent::GetStackCount(EEffectType EffectType, bool bIsBuff) const {
+	const FTantrumnActiveEffect* AppliedEffect = AppliedEffects.FindByPredicate([EffectType, bIsBuff](const FTantrumnActiveEffect& InAppliedEffect) {
+		return InAppliedEffect.EffectType == EffectType && InAppliedEffect.bIsBuff == bIsBuff;
+	});
+	return AppliedEffect ? AppliedEffect->StackCount : 0;
+}
+
+void UTantrumnStatusEffectComponent::SetBaseAttributeValue(ETantrumnAttribute Attribute, float InValue) {
+	BaseValues[(uint8)Attribute] = InValue;
+	RecalculateAttributes(1u << (uint32)Attribute);
+}
+
+void UTantrumnStatusEffectComponent::OnRep_ActiveEffects() {
+	UpdateAppliedEffects();
+}
+
+void UTantrumnStatusEffectComponent::OnEffectsExpired() {
+	if (GetOwner()->HasAuthority()) {
+		if (ActiveEffects.RemoveAll([this](const FTantrumnActiveEffect& ActiveEffect) { return !IsEffectActive(ActiveEffect); }) > 0) {
+			MARK_PROPERTY_DIRTY_FROM_NAME(UTantrumnStatusEffectComponent, ActiveEffects, this);
+		}
+	}
+	// clients expire on their own clock instead of waiting for the removal to replicate
+	UpdateAppliedEffects();
+}
+
+void UTantrumnStatusEffectComponent::UpdateAppliedEffects() {
+	TArray<FTantrumnActiveEffect> NewAppliedEffects;
+	for (const FTantrumnActiveEffect& ActiveEffect : ActiveEffects) {
+		if (IsEffectActive(ActiveEffect)) {
+			NewAppliedEffects.Add(ActiveEffect);
+		}
+	}
+
+	// only attributes touched by effects that started, stacked or ended need recalculating
+	uint32 DirtyAttributeMask = 0;
+	auto MarkChanged = [this, &DirtyAttributeMask](const FTantrumnActiveEffect& ChangedEffect, int32 NewStackCount) {
+		if (const UTantrumnEffectDefinition* Definition = GetDefinition(ChangedEffect.EffectType)) {
+			DirtyAttributeMask |= Definition->GetAttributeMask(ChangedEffect.bIsBuff);
+		}
+		OnEffectChanged.Broadcast(ChangedEffect.EffectType, ChangedEffect.bIsBuff, NewStackCount);
+	};
+
+	for (const FTantrumnActiveEffect& NewAppliedEffect : NewAppliedEffects) {
+		const FTantrumnActiveEffect* OldAppliedEffect = AppliedEffects.FindByPredicate([&NewAppliedEffect](const FTantrumnActiveEffect& InAppliedEffect) {
+			return InAppliedEffect.EffectType == NewAppliedEffect.EffectType && InAppliedEffect.bIsBuff == NewAppliedEffect.bIsBuff;
+		});
+		if (!OldAppliedEffect || OldAppliedEffect->StackCount != NewAppliedEffect.StackCount) {
+			MarkChanged(NewAppliedEffect, NewAppliedEffect.StackCount);
+		}
+	}
+	for (const FTantrumnActiveEffect& OldAppliedEffect : AppliedEffects) {
+		const bool bStillApplied = NewAppliedEffects.ContainsByPredicate([&OldAppliedEffect](const FTantrumnActiveEffect& InAppliedEffect) {
+			return InAppliedEffect.EffectType == OldAppliedEffect.EffectType && InAppliedEffect.bIsBuff == OldAppliedEffect.bIsBuff;
+		});
+		if (!bStillApplied) {
+			MarkChanged(OldAppliedEffect, 0);
+		}
+	}
+
+	AppliedEffects = MoveTemp(NewAppliedEffects);
+	if (DirtyAttributeMask != 0) {
+		RecalculateAttributes(DirtyAttributeMask);
+	}
+	ScheduleNextExpiry();
+}
+
+void UTantrumnStatusEffectComponent::RecalculateAttributes(uint32 AttributeMask) {
+	for (uint8 Index = 0; Index < (uint8)ETantrumnAttribute::Count; ++Index) {
+		if ((AttributeMask & (1u << Index)) == 0) {
+			continue;
+		}
+
+		const ETantrumnAttribute Attribute = (ETantrumnAttribute)Index;
+		float Additive = 0.0f;
+		float Multiplier = 1.0f;
+		for (const FTantrumnActiveEffect& AppliedEffect : AppliedEffects) {
+			const UTantrumnEffectDefinition* Definition = GetDefinition(AppliedEffect.EffectType);
+			if (!Definition) {
+				continue;
+			}
+			for (const FTantrumnAttributeModifier& Modifier : Definition->GetModifiers(AppliedEffect.bIsBuff)) {
+				if (Modifier.Attribute != Attribute) {
+					continue;
+				}
+				if (Modifier.Operation == ETantrumnModifierOp::Add) {
+					Additive += Modifier.Magnitude * AppliedEffect.StackCount;
+				}
+				else {
+					Multiplier *= FMath::Pow(Modifier.Magnitude, AppliedEffect.StackCount);
+				}
+			}
+		}
+
+		const float NewValue = (BaseValues[Index] + Additive) * Multiplier;
+		if (NewValue != CurrentValues[Index]) {
+			CurrentValues[Index] = NewValue;
+			OnAttributeChanged.Broadcast(Attribute, NewValue);
+		}
+	}
+}
+
+void UTantrumnStatusEffectComponent::ScheduleNextExpiry() {
+	if (AppliedEffects.Num() == 0) {
+		GetWorld()->GetTimerManager().ClearTimer(ExpiryTimerHandle);
+		return;
+	}
+
+	float NextEndTime = AppliedEffects[0].EndTime;
+	for (const FTantrumnActiveEffect& AppliedEffect : AppliedEffects) {
+		NextEndTime = FMath::Min(NextEndTime, AppliedEffect.EndTime);
+	}
+	const float RemainingTime = FMath::Max(NextEndTime - GetServerWorldTime(), KINDA_SMALL_NUMBER);
+	GetWorld()->GetTimerManager().SetTimer(ExpiryTimerHandle, this, &UTantrumnStatusEffectComponent::OnEffectsExpired, RemainingTime, false);
+}
@@ -0,0 +1,96 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "InteractInterface.h"
+#include "TantrumnEffectDefinition.h"
+#include "TantrumnStatusEffectComponent.generated.h"
+
+// an effect the server has applied, EndTime is in server world time
+USTRUCT()
+struct FTantrumnActiveEffect {
+	GENERATED_BODY()
+
+	UPROPERTY()
+	EEffectType EffectType = EEffectType::None;
+
+	UPROPERTY()
+	bool bIsBuff = false;
+
+	UPROPERTY()
+	uint8 StackCount = 0;
+
+	UPROPERTY()
+	float EndTime = 0.0f;
+};
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnTantrumnAttributeChanged, ETantrumnAttribute, float);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnEffectChanged, EEffectType, EffectType, bool, bIsBuff, int32, StackCount);
+
+/**
+ * Applies stackable effects described by UTantrumnEffectDefinition and keeps the owner's
+ * attributes aggregated from them. The server owns the active effects, every machine
+ * recalculates the attributes those effects touch when they start, stack or expire.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class TANTRUMN_API UTantrumnStatusEffectComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UTantrumnStatusEffectComponent();
+
+	void GetLifetimeReplicatedProps(TArray< FLifetimeProperty >& OutLifetimeProps) const override;
+
+	// server only
+	void ApplyEffect(EEffectType EffectType, bool bIsBuff);
+	void ClearEffects();
+
+	UFUNCTION(BlueprintPure)
+	float GetAttributeValue(ETantrumnAttribute Attribute) const { return CurrentValues[(uint8)Attribute]; }
+
+	// value before any effect, set by the owner from its own defaults
+	void SetBaseAttributeValue(ETantrumnAttribute Attribute, float InValue);
+
+	UFUNCTION(BlueprintPure)
+	int32 GetStackCount(EEffectType EffectType, bool bIsBuff) const;
+
+	// native only, fired for every attribute whose aggregated value changed
+	FOnTantrumnAttributeChanged OnAttributeChanged;
+
+	// stack count is 0 once the effect has ended
+	UPROPERTY(BlueprintAssignable)
+	FOnEffectChanged OnEffectChanged;
+
+protected:
+	const UTantrumnEffectDefinition* GetDefinition(EEffectType EffectType) const;
+	bool IsEffectActive(const FTantrumnActiveEffect& ActiveEffect) const;
+
+	void RecalculateAttributes(uint32 AttributeMask);
+	// one timer for the earliest expiry, effects cost nothing between changes
+	void ScheduleNextExpiry();
+	void OnEffectsExpired();
+
+	float GetServerWorldTime() const;
+
+	// defaults created in the constructor keep the original speed buff, assets can replace them per character
+	UPROPERTY(EditAnywhere, Category = "Effects")
+	TMap<EEffectType, UTantrumnEffectDefinition*> EffectDefinitions;
+
+	UPROPERTY(ReplicatedUsing = OnRep_ActiveEffects)
+	TArray<FTantrumnActiveEffect> ActiveEffects;
+
+	UFUNCTION()
+	void OnRep_ActiveEffects();
+
+	// effects this machine currently has applied, expired ones drop out before the server removes them
+	TArray<FTantrumnActiveEffect> AppliedEffects;
+	void UpdateAppliedEffects();
+
+	float BaseValues[(uint8)ETantrumnAttribute::Count];
+	float CurrentValues[(uint8)ETantrumnAttribute::Count];
+
+	FTimerHandle ExpiryTimerHandle;
+};
@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TantrumnThrowMetricsSubsystem.h"
+#include "Tantrumn.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogTantrumnThrowMetrics, Log, All)
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Attach Over Budget"), STAT_TantrumnAttachOverBudget, STATGROUP_Tantrumn);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Throw Latency Over Budget"), STAT_TantrumnThrowLatencyOverBudget, STATGROUP_Tantrumn);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Stuck Throw States"), STAT_TantrumnStuckThrowStates, STATGROUP_Tantrumn);
+
+static TAutoConsoleVariable<float> CVarAttachBudget(
+	TEXT("Tantrumn.Throw.AttachBudget"),
+	1.5f,
+	TEXT("Seconds from a pull request to the throwable attaching before it is reported as over budget"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarThrowLatencyBudget(
+	TEXT("Tantrumn.Throw.ThrowLatencyBudget"),
+	0.5f,
+	TEXT("Seconds from a predicted throw to the server acknowledging it before it is reported as over budget"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarStuckStateTimeout(
+	TEXT("Tantrumn.Throw.StuckStateTimeout"),
+	8.0f,
+	TEXT("Seconds a character or throwable may stay in a transient throw or pull state before it is reported as stuck, 0 disables"),
+	ECVF_Default
+);
+
+float UTantrumnThrowMetricsSubsystem::GetStuckStateTimeout() {
+	return CVarStuckStateTimeout->GetFloat();
+}
+
+void UTantrumnThrowMetricsSubsystem::RecordAttachTime(const AActor* InCharacter, float Seconds) {
+	AttachTimes.Add(Seconds);
+	if (Seconds > CVarAttachBudget->GetFloat()) {
+		++NumOverBudget;
+		INC_DWORD_STAT(STAT_TantrumnAttachOverBudget);
+		CSV_EVENT(Tantrumn, TEXT("AttachOverBudget"));
+		UE_LOG(LogTantrumnThrowMetrics, Warning, TEXT("%s took %.3fs to attach, budget %.3fs"), *GetNameSafe(InCharacter), Seconds, CVarAttachBudget->GetFloat());
+	}
+}
+
+void UTantrumnThrowMetricsSubsystem::RecordThrowLatency(const AActor* InCharacter, float Seconds) {
+	ThrowLatencies.Add(Seconds);
+	if (Seconds > CVarThrowLatencyBudget->GetFloat()) {
+		++NumOverBudget;
+		INC_DWORD_STAT(STAT_TantrumnThrowLatencyOverBudget);
+		CSV_EVENT(Tantrumn, TEXT("ThrowLatencyOverBudget"));
+		UE_LOG(LogTantrumnThrowMetrics, Warning, TEXT("%s throw acknowledged after %.3fs, budget %.3fs"), *GetNameSafe(InCharacter), Seconds, CVarThrowLatencyBudget->GetFloat());
+	}
+}
+
+void UTantrumnThrowMetricsSubsystem::RecordStuckState(const AActor* InActor, const FString& StateName, float Seconds) {
+	++NumStuckStates;
+	INC_DWORD_STAT(STAT_TantrumnStuckThrowStates);
+	CSV_EVENT(Tantrumn, TEXT("StuckState %s"), *StateName);
+	UE_LOG(LogTantrumnThrowMetrics, Error, TEXT("%s stuck in %s for %.1fs"), *GetNameSafe(InActor), *StateName, Seconds);
+}
+
+void UTantrumnThrowMetricsSubsystem::ResetSamples() {
+	AttachTimes.Reset();
+	ThrowLatencies.Reset();
+	NumStuckStates = 0;
+	NumOverBudget = 0;
+}
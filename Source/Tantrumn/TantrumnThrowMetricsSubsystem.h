@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TantrumnThrowMetricsSubsystem.generated.h"
+
+/**
+ * Checks the throw and pull state machines against their timing budgets while the game runs.
+ * Characters and throwables report time to attach, throw latency and states held past
+ * Tantrumn.Throw.StuckStateTimeout. Anything over budget is logged, counted in stat Tantrumn
+ * and marked in CSV captures, and the soak harness adds the samples to its results.
+ */
+UCLASS()
+class TANTRUMN_API UTantrumnThrowMetricsSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// from first pull request to the throwable attaching, on the machine that saw both
+	void RecordAttachTime(const AActor* InCharacter, float Seconds);
+	// from the owner predicting Throwing to the server acknowledging it
+	void RecordThrowLatency(const AActor* InCharacter, float Seconds);
+	void RecordStuckState(const AActor* InActor, const FString& StateName, float Seconds);
+
+	static float GetStuckStateTimeout();
+
+	const TArray<float>& GetAttachTimes() const { return AttachTimes; }
+	const TArray<float>& GetThrowLatencies() const { return ThrowLatencies; }
+	int32 GetNumStuckStates() const { return NumStuckStates; }
+	int32 GetNumOverBudget() const { return NumOverBudget; }
+
+	void ResetSamples();
+
+protected:
+	TArray<float> AttachTimes;
+	TArray<float> ThrowLatencies;
+	int32 NumStuckStates = 0;
+	int32 NumOverBudget = 0;
+};
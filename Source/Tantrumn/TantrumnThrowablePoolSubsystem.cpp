@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TantrumnThrowablePoolSubsystem.h"
+#include "ThrowableActor.h"
+
+void UTantrumnThrowablePoolSubsystem::Deinitialize() {
+	Pools.Empty();
+	Super::Deinitialize();
+}
+
+bool UTantrumnThrowablePoolSubsystem::CanPool() const {
+	// clients only ever see the replicated instances
+	return GetWorld() && GetWorld()->GetNetMode() != NM_Client;
+}
+
+AThrowableActor* UTantrumnThrowablePoolSubsystem::SpawnPooledThrowable(TSubclassOf<AThrowableActor> ThrowableClass) {
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	AThrowableActor* Throwable = GetWorld()->SpawnActor<AThrowableActor>(ThrowableClass, FTransform::Identity, SpawnParams);
+	if (Throwable) {
+		Throwable->SetPooled(true);
+	}
+	return Throwable;
+}
+
+void UTantrumnThrowablePoolSubsystem::Prewarm(TSubclassOf<AThrowableActor> ThrowableClass, int32 Count) {
+	if (!ThrowableClass || !CanPool()) {
+		return;
+	}
+
+	FTantrumnThrowablePool& Pool = Pools.FindOrAdd(ThrowableClass);
+	Pool.InactiveThrowables.Reserve(Count);
+	while (Pool.InactiveThrowables.Num() < Count) {
+		AThrowableActor* Throwable = SpawnPooledThrowable(ThrowableClass);
+		if (!Throwable) {
+			break;
+		}
+		Pool.InactiveThrowables.Add(Throwable);
+	}
+}
+
+AThrowableActor* UTantrumnThrowablePoolSubsystem::AcquireThrowable(TSubclassOf<AThrowableActor> ThrowableClass, const FTransform& Transform) {
+	if (!ThrowableClass || !CanPool()) {
+		return nullptr;
+	}
+
+	AThrowableActor* Throwable = nullptr;
+	if (FTantrumnThrowablePool* Pool = Pools.Find(ThrowableClass)) {
+		while (!Throwable && Pool->InactiveThrowables.Num() > 0) {
+			Throwable = Pool->InactiveThrowables.Pop(false);
+			if (Throwable && Throwable->IsPendingKill()) {
+				Throwable = nullptr;
+			}
+		}
+	}
+
+	if (!Throwable) {
+		Throwable = SpawnPooledThrowable(ThrowableClass);
+	}
+
+	if (Throwable) {
+		Throwable->SetPooled(false, &Transform);
+	}
+	return Throwable;
+}
+
+void UTantrumnThrowablePoolSubsystem::ReleaseThrowable(AThrowableActor* InThrowable) {
+	if (!InThrowable || InThrowable->IsPooled() || !CanPool()) {
+		return;
+	}
+
+	InThrowable->SetPooled(true);
+	Pools.FindOrAdd(InThrowable->GetClass()).InactiveThrowables.Add(InThrowable);
+}
+
+int32 UTantrumnThrowablePoolSubsystem::GetNumInactive(TSubclassOf<AThrowableActor> ThrowableClass) const {
+	const FTantrumnThrowablePool* Pool = Pools.Find(ThrowableClass);
+	return Pool ? Pool->InactiveThrowables.Num() : 0;
+}
@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TantrumnThrowablePoolSubsystem.generated.h"
+
+class AThrowableActor;
+
+USTRUCT()
+struct FTantrumnThrowablePool {
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<AThrowableActor*> InactiveThrowables;
+};
+
+/**
+ * Server side pool of throwables so using or resetting one never spawns or destroys an actor mid match.
+ */
+UCLASS()
+class TANTRUMN_API UTantrumnThrowablePoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// spawns inactive instances until the pool for the class holds at least Count
+	void Prewarm(TSubclassOf<AThrowableActor> ThrowableClass, int32 Count);
+
+	// returns a pooled instance placed at Transform, spawning a new one if the pool is empty
+	UFUNCTION(BlueprintCallable, Category = "Pool")
+	AThrowableActor* AcquireThrowable(TSubclassOf<AThrowableActor> ThrowableClass, const FTransform& Transform);
+
+	// hides and resets the throwable and keeps it for reuse, call instead of Destroy
+	UFUNCTION(BlueprintCallable, Category = "Pool")
+	void ReleaseThrowable(AThrowableActor* InThrowable);
+
+	int32 GetNumInactive(TSubclassOf<AThrowableActor> ThrowableClass) const;
+
+protected:
+	bool CanPool() const;
+
+	AThrowableActor* SpawnPooledThrowable(TSubclassOf<AThrowableActor> ThrowableClass);
+
+	UPROPERTY()
+	TMap<UClass*, FTantrumnThrowablePool> Pools;
+};
@@ -0,0 +1,129 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TantrumnThrowableSubsystem.h"
+#include "ThrowableActor.h"
+
+static TAutoConsoleVariable<float> CVarCandidateConeHalfAngle(
+	TEXT("Tantrumn.Throwable.CandidateConeHalfAngle"),
+	15.0f,
+	TEXT("Half angle (degrees) of the cone used to look up pickup candidates before tracing"),
+	ECVF_Default
+);
+
+void UTantrumnThrowableSubsystem::Deinitialize() {
+	ThrowableCells.Empty();
+	Grid.Empty();
+	Super::Deinitialize();
+}
+
+FIntVector UTantrumnThrowableSubsystem::GetCellCoord(const FVector& Location) const {
+	return FIntVector(
+		FMath::FloorToInt(Location.X / CellSize),
+		FMath::FloorToInt(Location.Y / CellSize),
+		FMath::FloorToInt(Location.Z / CellSize));
+}
+
+void UTantrumnThrowableSubsystem::RegisterIdleThrowable(AThrowableActor* InThrowable) {
+	if (!InThrowable || ThrowableCells.Contains(InThrowable)) {
+		return;
+	}
+
+	const FIntVector Cell = GetCellCoord(InThrowable->GetActorLocation());
+	ThrowableCells.Add(InThrowable, Cell);
+	Grid.FindOrAdd(Cell).Add(InThrowable);
+	if (InThrowable->GetRootComponent()) {
+		MaxBoundsRadius = FMath::Max(MaxBoundsRadius, InThrowable->GetRootComponent()->Bounds.SphereRadius);
+	}
+}
+
+void UTantrumnThrowableSubsystem::UnregisterIdleThrowable(AThrowableActor* InThrowable) {
+	FIntVector Cell;
+	if (!ThrowableCells.RemoveAndCopyValue(InThrowable, Cell)) {
+		return;
+	}
+
+	if (TArray<TWeakObjectPtr<AThrowableActor>>* CellThrowables = Grid.Find(Cell)) {
+		CellThrowables->RemoveSwap(InThrowable);
+		if (CellThrowables->Num() == 0) {
+			Grid.Remove(Cell);
+		}
+	}
+}
+
+void UTantrumnThrowableSubsystem::UpdateIdleThrowable(AThrowableActor* InThrowable) {
+	const FIntVector* CurrentCell = ThrowableCells.Find(InThrowable);
+	if (!CurrentCell || *CurrentCell == GetCellCoord(InThrowable->GetActorLocation())) {
+		return;
+	}
+
+	UnregisterIdleThrowable(InThrowable);
+	RegisterIdleThrowable(InThrowable);
+}
+
+bool UTantrumnThrowableSubsystem::IsInCone(const AThrowableActor* InThrowable, const FVector& Start, const FVector& Direction, float Length, float TraceRadius) const {
+	// pooled throwables are hidden on clients, which don't know about the pool state
+	if (InThrowable->IsHidden()) {
+		return false;
+	}
+
+	const float BoundsRadius = InThrowable->GetRootComponent() ? InThrowable->GetRootComponent()->Bounds.SphereRadius : 0.0f;
+	const FVector ToThrowable = InThrowable->GetActorLocation() - Start;
+	const float DistanceAlong = FVector::DotProduct(ToThrowable, Direction);
+	if (DistanceAlong < -BoundsRadius || DistanceAlong > Length + TraceRadius + BoundsRadius) {
+		return false;
+	}
+
+	const float ConeRadius = TraceRadius + BoundsRadius + (FMath::Max(DistanceAlong, 0.0f) * FMath::Tan(FMath::DegreesToRadians(CVarCandidateConeHalfAngle->GetFloat())));
+	const float DistanceFromAxisSq = (ToThrowable - (Direction * DistanceAlong)).SizeSquared();
+	return DistanceFromAxisSq <= ConeRadius * ConeRadius;
+}
+
+bool UTantrumnThrowableSubsystem::HasCandidateInCone(const FVector& Start, const FVector& End, float TraceRadius) const {
+	if (Grid.Num() == 0) {
+		return false;
+	}
+
+	const FVector Delta = End - Start;
+	const float Length = Delta.Size();
+	const FVector Direction = Length > KINDA_SMALL_NUMBER ? Delta / Length : FVector::ForwardVector;
+
+	// bounding box of the whole cone, used to limit the cells we visit
+	const float MaxConeRadius = TraceRadius + MaxBoundsRadius + (Length * FMath::Tan(FMath::DegreesToRadians(CVarCandidateConeHalfAngle->GetFloat())));
+	FBox ConeBounds(Start, Start);
+	ConeBounds += End;
+	ConeBounds = ConeBounds.ExpandBy(MaxConeRadius);
+
+	const FIntVector MinCell = GetCellCoord(ConeBounds.Min);
+	const FIntVector MaxCell = GetCellCoord(ConeBounds.Max);
+	const int64 NumCells = int64(MaxCell.X - MinCell.X + 1) * int64(MaxCell.Y - MinCell.Y + 1) * int64(MaxCell.Z - MinCell.Z + 1);
+
+	// when the cone covers more cells than are occupied it is cheaper to walk the occupied ones
+	if (NumCells > Grid.Num()) {
+		for (const TPair<FIntVector, TArray<TWeakObjectPtr<AThrowableActor>>>& Cell : Grid) {
+			for (const TWeakObjectPtr<AThrowableActor>& Throwable : Cell.Value) {
+				if (Throwable.IsValid() && IsInCone(Throwable.Get(), Start, Direction, Length, TraceRadius)) {
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X) {
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y) {
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z) {
+				const TArray<TWeakObjectPtr<AThrowableActor>>* CellThrowables = Grid.Find(FIntVector(X, Y, Z));
+				if (!CellThrowables) {
+					continue;
+				}
+				for (const TWeakObjectPtr<AThrowableActor>& Throwable : *CellThrowables) {
+					if (Throwable.IsValid() && IsInCone(Throwable.Get(), Start, Direction, Length, TraceRadius)) {
+						return true;
+					}
+				}
+			}
+		}
+	}
+	return false;
+}
@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TantrumnThrowableSubsystem.generated.h"
+
+class AThrowableActor;
+
+/**
+ * Keeps every idle AThrowableActor in a uniform grid so characters can cheaply
+ * check for pickup candidates before paying for a physics trace.
+ */
+UCLASS()
+class TANTRUMN_API UTantrumnThrowableSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	void RegisterIdleThrowable(AThrowableActor* InThrowable);
+	void UnregisterIdleThrowable(AThrowableActor* InThrowable);
+	// call when an idle throwable has been moved without changing state (e.g. replicated movement)
+	void UpdateIdleThrowable(AThrowableActor* InThrowable);
+
+	// returns true if any idle throwable lies inside the cone from Start to End
+	bool HasCandidateInCone(const FVector& Start, const FVector& End, float TraceRadius) const;
+
+	int32 GetNumIdleThrowables() const { return ThrowableCells.Num(); }
+
+protected:
+	FIntVector GetCellCoord(const FVector& Location) const;
+
+	bool IsInCone(const AThrowableActor* InThrowable, const FVector& Start, const FVector& Direction, float Length, float TraceRadius) const;
+
+	// size of a grid cell in world units, roughly half the pickup trace distance
+	float CellSize = 500.0f;
+
+	// largest bounds of any registered throwable, used to pad cell lookups
+	float MaxBoundsRadius = 0.0f;
+
+	// the cell each registered throwable currently lives in
+	TMap<TWeakObjectPtr<AThrowableActor>, FIntVector> ThrowableCells;
+
+	TMap<FIntVector, TArray<TWeakObjectPtr<AThrowableActor>>> Grid;
+};
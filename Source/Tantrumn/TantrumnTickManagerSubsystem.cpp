@@ -0,0 +1,123 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TantrumnTickManagerSubsystem.h"
+#include "Tantrumn.h"
+#include "TantrumnCharacterBase.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "TimerManager.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Characters Ticking"), STAT_TantrumnCharactersTicking, STATGROUP_Tantrumn);
+
+static TAutoConsoleVariable<float> CVarSignificanceUpdateInterval(
+	TEXT("Tantrumn.Tick.SignificanceUpdateInterval"),
+	0.25f,
+	TEXT("Seconds between updates of character significance from their distance to local viewers"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarReducedTickDistance(
+	TEXT("Tantrumn.Tick.ReducedTickDistance"),
+	3000.0f,
+	TEXT("Distance from the nearest local viewer beyond which remote characters animate at the reduced interval"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarReducedMeshTickInterval(
+	TEXT("Tantrumn.Tick.ReducedMeshTickInterval"),
+	0.1f,
+	TEXT("Mesh tick interval in seconds for distant or unseen remote characters, 0 animates them every frame"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarRecentlyRenderedTime(
+	TEXT("Tantrumn.Tick.RecentlyRenderedTime"),
+	0.5f,
+	TEXT("Seconds since last render after which a remote character counts as unseen"),
+	ECVF_Default
+);
+
+void UTantrumnTickManagerSubsystem::Deinitialize() {
+	if (UWorld* World = GetWorld()) {
+		World->GetTimerManager().ClearTimer(SignificanceTimerHandle);
+	}
+	Characters.Empty();
+	Super::Deinitialize();
+}
+
+void UTantrumnTickManagerSubsystem::RegisterCharacter(ATantrumnCharacterBase* InCharacter) {
+	Characters.AddUnique(InCharacter);
+	RefreshCharacterTick(InCharacter);
+
+	// remote copies are cosmetic, off screen only montages need to keep advancing so notifies still fire
+	if (InCharacter->GetLocalRole() == ROLE_SimulatedProxy) {
+		InCharacter->GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+	}
+
+	// a dedicated server has no viewers and no simulated characters to reduce
+	if (GetWorld()->GetNetMode() != NM_DedicatedServer && !SignificanceTimerHandle.IsValid()) {
+		GetWorld()->GetTimerManager().SetTimer(SignificanceTimerHandle, this, &UTantrumnTickManagerSubsystem::UpdateSignificance, FMath::Max(CVarSignificanceUpdateInterval->GetFloat(), 0.05f), true);
+	}
+}
+
+void UTantrumnTickManagerSubsystem::UnregisterCharacter(ATantrumnCharacterBase* InCharacter) {
+	if (InCharacter->IsActorTickEnabled()) {
+		DEC_DWORD_STAT(STAT_TantrumnCharactersTicking);
+	}
+	Characters.RemoveSwap(InCharacter);
+}
+
+void UTantrumnTickManagerSubsystem::RefreshCharacterTick(ATantrumnCharacterBase* InCharacter) {
+	const bool bNeedsTick = InCharacter->NeedsTick();
+	if (InCharacter->IsActorTickEnabled() == bNeedsTick) {
+		return;
+	}
+
+	InCharacter->SetActorTickEnabled(bNeedsTick);
+	if (bNeedsTick) {
+		INC_DWORD_STAT(STAT_TantrumnCharactersTicking);
+	}
+	else {
+		DEC_DWORD_STAT(STAT_TantrumnCharactersTicking);
+	}
+}
+
+void UTantrumnTickManagerSubsystem::UpdateSignificance() {
+	TArray<FVector> ViewLocations;
+	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator) {
+		APlayerController* PlayerController = Iterator->Get();
+		if (PlayerController && PlayerController->IsLocalController() && PlayerController->PlayerCameraManager) {
+			ViewLocations.Add(PlayerController->PlayerCameraManager->GetCameraLocation());
+		}
+	}
+
+	for (int32 Index = Characters.Num() - 1; Index >= 0; --Index) {
+		ATantrumnCharacterBase* Character = Characters[Index].Get();
+		if (!Character) {
+			Characters.RemoveAtSwap(Index);
+			continue;
+		}
+
+		if (Character->GetLocalRole() == ROLE_SimulatedProxy) {
+			const float MeshTickInterval = IsSignificant(Character, ViewLocations) ? 0.0f : FMath::Max(CVarReducedMeshTickInterval->GetFloat(), 0.0f);
+			Character->GetMesh()->SetComponentTickInterval(MeshTickInterval);
+		}
+	}
+}
+
+bool UTantrumnTickManagerSubsystem::IsSignificant(const ATantrumnCharacterBase* InCharacter, const TArray<FVector>& ViewLocations) const {
+	if (!InCharacter->WasRecentlyRendered(CVarRecentlyRenderedTime->GetFloat())) {
+		return false;
+	}
+
+	const float ReducedTickDistance = CVarReducedTickDistance->GetFloat();
+	const FVector CharacterLocation = InCharacter->GetActorLocation();
+	for (const FVector& ViewLocation : ViewLocations) {
+		if (FVector::DistSquared(ViewLocation, CharacterLocation) <= FMath::Square(ReducedTickDistance)) {
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,38 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TantrumnTickManagerSubsystem.generated.h"
+
+class ATantrumnCharacterBase;
+
+/**
+ * Decides which characters tick and how often. Characters only tick while they have
+ * frame work to do, remote characters that are unseen or far from every local viewer
+ * update their animation at a reduced rate.
+ */
+UCLASS()
+class TANTRUMN_API UTantrumnTickManagerSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	void RegisterCharacter(ATantrumnCharacterBase* InCharacter);
+	void UnregisterCharacter(ATantrumnCharacterBase* InCharacter);
+
+	// call whenever something the character ticks for changes, enables or disables its tick
+	void RefreshCharacterTick(ATantrumnCharacterBase* InCharacter);
+
+protected:
+	// significance only changes as characters move, so it is updated on a timer rather than every frame
+	void UpdateSignificance();
+	bool IsSignificant(const ATantrumnCharacterBase* InCharacter, const TArray<FVector>& ViewLocations) const;
+
+	TArray<TWeakObjectPtr<ATantrumnCharacterBase>> Characters;
+
+	FTimerHandle SignificanceTimerHandle;
+};
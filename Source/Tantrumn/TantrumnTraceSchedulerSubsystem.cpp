@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TantrumnTraceSchedulerSubsystem.h"
+#include "Tantrumn.h"
+#include "TantrumnCharacterBase.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pickup Traces Run"), STAT_TantrumnPickupTracesRun, STATGROUP_Tantrumn);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pickup Traces Skipped"), STAT_TantrumnPickupTracesSkipped, STATGROUP_Tantrumn);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pickup Traces Deferred"), STAT_TantrumnPickupTracesDeferred, STATGROUP_Tantrumn);
+
+static TAutoConsoleVariable<int> CVarTraceBudget(
+	TEXT("Tantrumn.Character.TraceBudget"),
+	8,
+	TEXT("Maximum number of pickup traces run per frame across all characters, 0 or less disables the budget"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int> CVarLowPriorityTraceInterval(
+	TEXT("Tantrumn.Character.LowPriorityTraceInterval"),
+	4,
+	TEXT("Frames between pickup traces for characters that are sprinting or not requesting a pull"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int> CVarMaxTraceDeferFrames(
+	TEXT("Tantrumn.Character.MaxTraceDeferFrames"),
+	6,
+	TEXT("Frames after which a character traces even if the per frame budget is used up, bounds highlight latency"),
+	ECVF_Default
+);
+
+void UTantrumnTraceSchedulerSubsystem::Deinitialize() {
+	LastTraceFrames.Empty();
+	Super::Deinitialize();
+}
+
+bool UTantrumnTraceSchedulerSubsystem::TryConsumeTraceSlot(const ATantrumnCharacterBase* InCharacter, bool bLowPriority) {
+	if (CurrentFrame != GFrameCounter) {
+		CurrentFrame = GFrameCounter;
+		TracesThisFrame = 0;
+	}
+
+	uint64& LastTraceFrame = LastTraceFrames.FindOrAdd(InCharacter, 0);
+	const uint64 FramesSinceTrace = CurrentFrame - LastTraceFrame;
+
+	const uint64 TraceInterval = bLowPriority ? (uint64)FMath::Max(CVarLowPriorityTraceInterval->GetInt(), 1) : 1;
+	if (FramesSinceTrace < TraceInterval) {
+		INC_DWORD_STAT(STAT_TantrumnPickupTracesSkipped);
+		return false;
+	}
+
+	const int32 TraceBudget = CVarTraceBudget->GetInt();
+	const bool bOverBudget = TraceBudget > 0 && TracesThisFrame >= TraceBudget;
+	if (bOverBudget && FramesSinceTrace < (uint64)FMath::Max(CVarMaxTraceDeferFrames->GetInt(), 1)) {
+		INC_DWORD_STAT(STAT_TantrumnPickupTracesDeferred);
+		return false;
+	}
+
+	++TracesThisFrame;
+	LastTraceFrame = CurrentFrame;
+	INC_DWORD_STAT(STAT_TantrumnPickupTracesRun);
+	return true;
+}
+
+void UTantrumnTraceSchedulerSubsystem::UnregisterCharacter(const ATantrumnCharacterBase* InCharacter) {
+	LastTraceFrames.Remove(InCharacter);
+}
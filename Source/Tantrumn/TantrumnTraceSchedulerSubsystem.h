@@ -0,0 +1,34 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TantrumnTraceSchedulerSubsystem.generated.h"
+
+class ATantrumnCharacterBase;
+
+/**
+ * Hands out pickup trace slots to characters so the number of traces per frame
+ * stays within a budget no matter how many characters are in the world.
+ */
+UCLASS()
+class TANTRUMN_API UTantrumnTraceSchedulerSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// returns true if the character may trace this frame, low priority characters trace at a reduced rate
+	bool TryConsumeTraceSlot(const ATantrumnCharacterBase* InCharacter, bool bLowPriority);
+
+	void UnregisterCharacter(const ATantrumnCharacterBase* InCharacter);
+
+protected:
+	uint64 CurrentFrame = 0;
+	int32 TracesThisFrame = 0;
+
+	// frame number of the last trace each character was allowed to run
+	TMap<TWeakObjectPtr<const ATantrumnCharacterBase>, uint64> LastTraceFrames;
+};
@@ -0,0 +1,272 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
+
+#include "Editor.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "Settings/LevelEditorPlaySettings.h"
+#include "Tests/AutomationEditorCommon.h"
+#include "TantrumnCharacterBase.h"
+#include "TantrumnThrowMetricsSubsystem.h"
+#include "ThrowableActor.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogTantrumnThrowBudgetTest, Log, All)
+
+namespace TantrumnThrowBudgetTest {
+	// multiplayer map without bots, nothing else pulls or stuns the test player
+	static const TCHAR* MapName = TEXT("/Game/Tantrumn/Maps/Playground_Gameloop");
+	static const float PullDistance = 250.0f;
+	static const float PlayersTimeout = 30.0f;
+
+	static UWorld* FindPlayWorld(ENetMode NetMode) {
+		for (const FWorldContext& Context : GEngine->GetWorldContexts()) {
+			UWorld* World = Context.World();
+			if (Context.WorldType == EWorldType::PIE && World && World->GetNetMode() == NetMode) {
+				return World;
+			}
+		}
+		return nullptr;
+	}
+
+	static float GetCVarFloat(const TCHAR* Name) {
+		const IConsoleVariable* CVar = IConsoleManager::Get().FindConsoleVariable(Name);
+		return CVar ? CVar->GetFloat() : 0.0f;
+	}
+}
+
+// listen server with its own player plus one client, both in this process
+class FTantrumnStartNetPlayCommand : public IAutomationLatentCommand {
+public:
+	virtual bool Update() override {
+		ULevelEditorPlaySettings* PlaySettings = DuplicateObject(GetDefault<ULevelEditorPlaySettings>(), GetTransientPackage());
+		PlaySettings->SetPlayNetMode(EPlayNetMode::PIE_ListenServer);
+		PlaySettings->SetPlayNumberOfClients(2);
+		PlaySettings->SetRunUnderOneProcess(true);
+		PlaySettings->bLaunchSeparateServer = false;
+
+		FRequestPlaySessionParams Params;
+		Params.EditorPlaySettings = PlaySettings;
+		GEditor->RequestPlaySession(Params);
+		return true;
+	}
+};
+
+class FTantrumnEndNetPlayCommand : public IAutomationLatentCommand {
+public:
+	virtual bool Update() override {
+		GEditor->RequestEndPlayMap();
+		return true;
+	}
+};
+
+/**
+ * Pulls and throws with the client's character under the given packet lag and loss, then fails
+ * the test if any attach or throw acknowledgement went over Tantrumn.Throw.AttachBudget or
+ * Tantrumn.Throw.ThrowLatencyBudget, or anything stayed in a pull or throw state for longer
+ * than Tantrumn.Throw.StuckStateTimeout.
+ */
+class FTantrumnThrowBudgetCommand : public IAutomationLatentCommand {
+public:
+	FTantrumnThrowBudgetCommand(FAutomationTestBase* InTest, int32 InPktLag, int32 InPktLoss)
+		: Test(InTest), PktLag(InPktLag), PktLoss(InPktLoss) {
+	}
+
+	virtual bool Update() override {
+		switch (Step) {
+		case EStep::WaitForPlayers:
+			if (FindPlayers()) {
+				ApplyNetConditions();
+				PlaceThrowable();
+				NextStep();
+			}
+			else if (TimedOut(TantrumnThrowBudgetTest::PlayersTimeout)) {
+				return Fail(TEXT("listen server and client never both had a character"));
+			}
+			break;
+
+		case EStep::Pull:
+			// the moved throwable reaches the client a round trip later, keep trying until it is there
+			if (ClientCharacter->AttemptPullObjectAtLocation(PullLocation)) {
+				NextStep();
+			}
+			else if (TimedOut(5.0f)) {
+				return Fail(TEXT("client could not start pulling the throwable"));
+			}
+			break;
+
+		case EStep::WaitForAttach:
+			if (ClientCharacter->GetCharacterThrowState() == ECharacterThrowState::Attached) {
+				ClientCharacter->RequestThrowObject();
+				if (!ClientCharacter->IsThrowing()) {
+					return Fail(TEXT("client could not start the throw"));
+				}
+				NextStep();
+			}
+			else if (TimedOut(TantrumnThrowBudgetTest::GetCVarFloat(TEXT("Tantrumn.Throw.StuckStateTimeout")))) {
+				return Fail(TEXT("throwable never attached to the client"));
+			}
+			break;
+
+		case EStep::WaitForThrowAck:
+			if (ClientMetrics->GetThrowLatencies().Num() > 0) {
+				NextStep();
+			}
+			else if (TimedOut(TantrumnThrowBudgetTest::GetCVarFloat(TEXT("Tantrumn.Throw.StuckStateTimeout")))) {
+				return Fail(TEXT("server never acknowledged the throw"));
+			}
+			break;
+
+		case EStep::WaitForLanding:
+			if (ServerThrowable->IsIdle()) {
+				return Finish();
+			}
+			else if (TimedOut(TantrumnThrowBudgetTest::GetCVarFloat(TEXT("Tantrumn.Throw.StuckStateTimeout")) + 2.0f)) {
+				return Fail(TEXT("thrown throwable never came to rest"));
+			}
+			break;
+		}
+		return false;
+	}
+
+private:
+	enum class EStep {
+		WaitForPlayers,
+		Pull,
+		WaitForAttach,
+		WaitForThrowAck,
+		WaitForLanding,
+	};
+
+	bool FindPlayers() {
+		UWorld* ServerWorld = TantrumnThrowBudgetTest::FindPlayWorld(NM_ListenServer);
+		UWorld* ClientWorld = TantrumnThrowBudgetTest::FindPlayWorld(NM_Client);
+		if (!ServerWorld || !ClientWorld) {
+			return false;
+		}
+
+		APlayerController* ClientController = ClientWorld->GetFirstPlayerController();
+		ClientCharacter = ClientController ? Cast<ATantrumnCharacterBase>(ClientController->GetPawn()) : nullptr;
+
+		ServerCharacter = nullptr;
+		for (FConstPlayerControllerIterator It = ServerWorld->GetPlayerControllerIterator(); It; ++It) {
+			if (It->IsValid() && !(*It)->IsLocalController()) {
+				ServerCharacter = Cast<ATantrumnCharacterBase>((*It)->GetPawn());
+			}
+		}
+
+		ServerThrowable = nullptr;
+		for (TActorIterator<AThrowableActor> It(ServerWorld); It && !ServerThrowable; ++It) {
+			if (It->IsIdle()) {
+				ServerThrowable = *It;
+			}
+		}
+
+		ServerMetrics = ServerWorld->GetSubsystem<UTantrumnThrowMetricsSubsystem>();
+		ClientMetrics = ClientWorld->GetSubsystem<UTantrumnThrowMetricsSubsystem>();
+		return ClientCharacter && ServerCharacter && ServerThrowable && ServerMetrics && ClientMetrics;
+	}
+
+	void ApplyNetConditions() {
+		// both drivers delay and drop what they send, so lag applies each way
+		const FString Command = FString::Printf(TEXT("Net PktLag=%d PktLoss=%d"), PktLag, PktLoss);
+		GEngine->Exec(ServerCharacter->GetWorld(), *Command);
+		GEngine->Exec(ClientCharacter->GetWorld(), *Command);
+		ServerMetrics->ResetSamples();
+		ClientMetrics->ResetSamples();
+	}
+
+	void PlaceThrowable() {
+		PullLocation = ServerCharacter->GetActorLocation() + ServerCharacter->GetActorForwardVector() * TantrumnThrowBudgetTest::PullDistance;
+		FTransform Transform = ServerThrowable->GetActorTransform();
+		Transform.SetLocation(PullLocation);
+		ServerThrowable->ResetToIdle(Transform);
+	}
+
+	void NextStep() {
+		Step = (EStep)((uint8)Step + 1);
+		StepStartSeconds = FPlatformTime::Seconds();
+	}
+
+	bool TimedOut(float Seconds) const {
+		return FPlatformTime::Seconds() - StepStartSeconds > Seconds;
+	}
+
+	bool Fail(const FString& Reason) {
+		Test->AddError(FString::Printf(TEXT("PktLag=%d PktLoss=%d: %s"), PktLag, PktLoss, *Reason));
+		CheckBudgets();
+		return true;
+	}
+
+	bool Finish() {
+		CheckBudgets();
+		return true;
+	}
+
+	void CheckBudgets() {
+		if (!ServerMetrics || !ClientMetrics) {
+			return;
+		}
+
+		for (float Seconds : ClientMetrics->GetAttachTimes()) {
+			Test->AddInfo(FString::Printf(TEXT("attach %.3fs, budget %.3fs"), Seconds, TantrumnThrowBudgetTest::GetCVarFloat(TEXT("Tantrumn.Throw.AttachBudget"))));
+		}
+		for (float Seconds : ClientMetrics->GetThrowLatencies()) {
+			Test->AddInfo(FString::Printf(TEXT("throw latency %.3fs, budget %.3fs"), Seconds, TantrumnThrowBudgetTest::GetCVarFloat(TEXT("Tantrumn.Throw.ThrowLatencyBudget"))));
+		}
+
+		const int32 NumOverBudget = ServerMetrics->GetNumOverBudget() + ClientMetrics->GetNumOverBudget();
+		if (NumOverBudget > 0) {
+			Test->AddError(FString::Printf(TEXT("PktLag=%d PktLoss=%d: %d timings over budget"), PktLag, PktLoss, NumOverBudget));
+		}
+		const int32 NumStuckStates = ServerMetrics->GetNumStuckStates() + ClientMetrics->GetNumStuckStates();
+		if (NumStuckStates > 0) {
+			Test->AddError(FString::Printf(TEXT("PktLag=%d PktLoss=%d: %d stuck throw or pull states"), PktLag, PktLoss, NumStuckStates));
+		}
+	}
+
+	FAutomationTestBase* Test = nullptr;
+	int32 PktLag = 0;
+	int32 PktLoss = 0;
+
+	EStep Step = EStep::WaitForPlayers;
+	double StepStartSeconds = FPlatformTime::Seconds();
+	FVector PullLocation = FVector::ZeroVector;
+
+	TWeakObjectPtr<ATantrumnCharacterBase> ClientCharacter;
+	TWeakObjectPtr<ATantrumnCharacterBase> ServerCharacter;
+	TWeakObjectPtr<AThrowableActor> ServerThrowable;
+	TWeakObjectPtr<UTantrumnThrowMetricsSubsystem> ServerMetrics;
+	TWeakObjectPtr<UTantrumnThrowMetricsSubsystem> ClientMetrics;
+};
+
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FTantrumnThrowBudgetTest, "Tantrumn.Throw.Budgets", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+void FTantrumnThrowBudgetTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const {
+	// parameters are PktLag in milliseconds and PktLoss in percent, applied on both ends
+	OutBeautifiedNames.Add(TEXT("NoLag"));
+	OutTestCommands.Add(TEXT("0 0"));
+	OutBeautifiedNames.Add(TEXT("Lag60"));
+	OutTestCommands.Add(TEXT("60 0"));
+	OutBeautifiedNames.Add(TEXT("Lag100Loss2"));
+	OutTestCommands.Add(TEXT("100 2"));
+}
+
+bool FTantrumnThrowBudgetTest::RunTest(const FString& Parameters) {
+	TArray<FString> Values;
+	Parameters.ParseIntoArrayWS(Values);
+	const int32 PktLag = Values.IsValidIndex(0) ? FCString::Atoi(*Values[0]) : 0;
+	const int32 PktLoss = Values.IsValidIndex(1) ? FCString::Atoi(*Values[1]) : 0;
+	UE_LOG(LogTantrumnThrowBudgetTest, Display, TEXT("Throw budgets with PktLag=%d PktLoss=%d on %s"), PktLag, PktLoss, TantrumnThrowBudgetTest::MapName);
+
+	FAutomationEditorCommonUtils::LoadMap(TantrumnThrowBudgetTest::MapName);
+	ADD_LATENT_AUTOMATION_COMMAND(FTantrumnStartNetPlayCommand());
+	ADD_LATENT_AUTOMATION_COMMAND(FTantrumnThrowBudgetCommand(this, PktLag, PktLoss));
+	ADD_LATENT_AUTOMATION_COMMAND(FTantrumnEndNetPlayCommand());
+	return true;
+}
+
+#endif
@@ -2,19 +2,68 @@
 
 
 #include "ThrowableActor.h"
+#include "Tantrumn.h"
 #include "Components/StaticMeshComponent.h"
 #include "GameFramework/Character.h"
+#include "GameFramework/GameStateBase.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "InteractInterface.h"
+#include "EngineUtils.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 #include "TantrumnCharacterBase.h"
+#include "TantrumnLagCompensationComponent.h"
+#include "TantrumnThrowablePoolSubsystem.h"
+#include "TantrumnThrowableSubsystem.h"
+#include "TantrumnThrowMetricsSubsystem.h"
+
+DECLARE_CYCLE_STAT(TEXT("Throwable Notify Hit"), STAT_TantrumnThrowableNotifyHit, STATGROUP_Tantrumn);
+DECLARE_CYCLE_STAT(TEXT("Throwable Flight Step"), STAT_TantrumnThrowableFlightStep, STATGROUP_Tantrumn);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Throwables Idle"), STAT_TantrumnThrowablesIdle, STATGROUP_Tantrumn);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Throwables Pull"), STAT_TantrumnThrowablesPull, STATGROUP_Tantrumn);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Throwables Attached"), STAT_TantrumnThrowablesAttached, STATGROUP_Tantrumn);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Throwables Launch"), STAT_TantrumnThrowablesLaunch, STATGROUP_Tantrumn);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Throwables Dropped"), STAT_TantrumnThrowablesDropped, STATGROUP_Tantrumn);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Throwables Pooled"), STAT_TantrumnThrowablesPooled, STATGROUP_Tantrumn);
+
+static TAutoConsoleVariable<int32> CVarFixedStepFlight(
+	TEXT("Tantrumn.Throw.FixedStepFlight"),
+	0,
+	TEXT("Fly throwables with fixed steps instead of the projectile component, clients simulate throws and drops from a launch event"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarFixedStepRate(
+	TEXT("Tantrumn.Throw.FixedStepRate"),
+	60.0f,
+	TEXT("Steps per second of fixed step flight, must match between server and clients for their flights to agree"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int32> CVarMaxFlightSteps(
+	TEXT("Tantrumn.Throw.MaxFlightStepsPerFrame"),
+	8,
+	TEXT("Fixed flight steps simulated in one frame at most, steps over it are caught up on the following frames"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarMaxFlightCatchUp(
+	TEXT("Tantrumn.Throw.MaxFlightCatchUp"),
+	1.0f,
+	TEXT("Seconds of a flight a client steps through when its launch event arrives late, older events are left to replicated movement"),
+	ECVF_Default
+);
 
 // Sets default values
 AThrowableActor::AThrowableActor()
 {
- 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = false;
+ 	// only ticks during fixed step flights, or on the server while launched to check hits against rewound characters
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
 	bReplicates = true;
 	SetReplicateMovement(true);
+	// idle throwables have nothing to send, stay dormant until pulled
+	NetDormancy = DORM_Initial;
 	StaticMeshComponent = CreateDefaultSubobject<UStaticMeshComponent>("StaticMeshComponent");
 	ProjectileMovementComponent = CreateDefaultSubobject<UProjectileMovementComponent>("ProjectileMovementComponent");
 	RootComponent = StaticMeshComponent;
@@ -24,21 +73,147 @@ AThrowableActor::AThrowableActor()
 void AThrowableActor::BeginPlay()
 {
 	Super::BeginPlay();
+	UpdateStateStat(State, true);
 	if (HasAuthority()) {
 		ProjectileMovementComponent->OnProjectileStop.AddDynamic(this, &AThrowableActor::ProjectileStop);
+		// DORM_Initial only applies to actors placed in the level, spawned ones go dormant after their first update
+		if (IsIdle() && !IsNetStartupActor()) {
+			SetNetDormancy(DORM_DormantAll);
+		}
+	}
+	if (IsIdle() && !bPooled) {
+		if (UTantrumnThrowableSubsystem* ThrowableSubsystem = GetWorld()->GetSubsystem<UTantrumnThrowableSubsystem>()) {
+			ThrowableSubsystem->RegisterIdleThrowable(this);
+		}
 	}
 }
 
 void AThrowableActor::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+	UpdateStateStat(State, false);
 	if (HasAuthority()) {
 		ProjectileMovementComponent->OnProjectileStop.RemoveDynamic(this, &AThrowableActor::ProjectileStop);
 	}
+	if (UTantrumnThrowableSubsystem* ThrowableSubsystem = GetWorld()->GetSubsystem<UTantrumnThrowableSubsystem>()) {
+		ThrowableSubsystem->UnregisterIdleThrowable(this);
+	}
 	Super::EndPlay(EndPlayReason);
 }
 
+void AThrowableActor::GetLifetimeReplicatedProps(TArray< FLifetimeProperty >& OutLifetimeProps) const {
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams SharedParams;
+	SharedParams.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(AThrowableActor, LaunchEvent, SharedParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AThrowableActor, bPooled, SharedParams);
+}
+
+void AThrowableActor::OnRep_ReplicatedMovement() {
+	// movement only replicates again once the server's flight has ended, where it stopped wins
+	EndFixedStepFlight();
+	Super::OnRep_ReplicatedMovement();
+	// clients only see idle throwables move through replication, keep the index cell current
+	if (IsIdle() && !bPooled) {
+		if (UTantrumnThrowableSubsystem* ThrowableSubsystem = GetWorld()->GetSubsystem<UTantrumnThrowableSubsystem>()) {
+			ThrowableSubsystem->UpdateIdleThrowable(this);
+		}
+	}
+}
+
+void AThrowableActor::SetState(EState InState) {
+	if (State == InState) {
+		return;
+	}
+
+	const bool bWasIdle = IsIdle();
+	const bool bWasDormant = ShouldBeDormant();
+	// counted from BeginPlay, earlier changes only decide the starting state
+	if (HasActorBegunPlay()) {
+		UpdateStateStat(State, false);
+		UpdateStateStat(InState, true);
+	}
+	State = InState;
+
+	const float StuckStateTimeout = UTantrumnThrowMetricsSubsystem::GetStuckStateTimeout();
+	if (StuckStateTimeout > 0.0f && (State == EState::Pull || State == EState::Launch || State == EState::Dropped)) {
+		GetWorldTimerManager().SetTimer(StuckStateTimerHandle, this, &AThrowableActor::OnStateStuck, StuckStateTimeout, false);
+	}
+	else {
+		GetWorldTimerManager().ClearTimer(StuckStateTimerHandle);
+	}
+
+	if (HasAuthority()) {
+		if (bPooled != IsPooled()) {
+			bPooled = IsPooled();
+			MARK_PROPERTY_DIRTY_FROM_NAME(AThrowableActor, bPooled, this);
+		}
+
+		if (ShouldBeDormant() && bWasDormant) {
+			// moving in or out of the pool while asleep, send the change and stay dormant
+			FlushNetDormancy();
+		}
+		else if (ShouldBeDormant()) {
+			// make sure the resting transform goes out before the channel closes
+			ForceNetUpdate();
+			SetNetDormancy(DORM_DormantAll);
+		}
+		else if (bWasDormant) {
+			SetNetDormancy(DORM_Awake);
+		}
+	}
+
+	if (bWasIdle == IsIdle()) {
+		return;
+	}
+
+	if (UTantrumnThrowableSubsystem* ThrowableSubsystem = GetWorld()->GetSubsystem<UTantrumnThrowableSubsystem>()) {
+		if (IsIdle()) {
+			ThrowableSubsystem->RegisterIdleThrowable(this);
+		}
+		else {
+			ThrowableSubsystem->UnregisterIdleThrowable(this);
+		}
+	}
+}
+
+void AThrowableActor::UpdateStateStat(EState InState, bool bAdd) {
+#if STATS
+#define UPDATE_STATE_STAT(Stat) if (bAdd) { INC_DWORD_STAT(Stat); } else { DEC_DWORD_STAT(Stat); }
+	switch (InState) {
+	case EState::Idle:
+		UPDATE_STATE_STAT(STAT_TantrumnThrowablesIdle);
+		break;
+	case EState::Pull:
+		UPDATE_STATE_STAT(STAT_TantrumnThrowablesPull);
+		break;
+	case EState::Attached:
+		UPDATE_STATE_STAT(STAT_TantrumnThrowablesAttached);
+		break;
+	case EState::Launch:
+		UPDATE_STATE_STAT(STAT_TantrumnThrowablesLaunch);
+		break;
+	case EState::Dropped:
+		UPDATE_STATE_STAT(STAT_TantrumnThrowablesDropped);
+		break;
+	case EState::Pooled:
+		UPDATE_STATE_STAT(STAT_TantrumnThrowablesPooled);
+		break;
+	}
+#undef UPDATE_STATE_STAT
+#endif
+}
+
+void AThrowableActor::OnStateStuck() {
+	static const TCHAR* StateNames[] = { TEXT("Idle"), TEXT("Pull"), TEXT("Attached"), TEXT("Launch"), TEXT("Dropped"), TEXT("Pooled") };
+	if (UTantrumnThrowMetricsSubsystem* ThrowMetrics = GetWorld()->GetSubsystem<UTantrumnThrowMetricsSubsystem>()) {
+		ThrowMetrics->RecordStuckState(this, StateNames[(int32)State], UTantrumnThrowMetricsSubsystem::GetStuckStateTimeout());
+	}
+}
+
 void AThrowableActor::NotifyHit(UPrimitiveComponent* MyComp, AActor* Other, UPrimitiveComponent* OtherComp, bool bSelfMoved, FVector HitLocation, FVector HitNormal, FVector NormalImpulse, const FHitResult& Hit) {
+	TANTRUMN_SCOPE_CYCLE_COUNTER(STAT_TantrumnThrowableNotifyHit);
 	Super::NotifyHit(MyComp, Other, OtherComp, bSelfMoved, HitLocation, HitNormal, NormalImpulse, Hit);
-	if (State == EState::Idle || State == EState::Attached || State == EState::Dropped) {
+	if (State == EState::Idle || State == EState::Attached || State == EState::Dropped || State == EState::Pooled) {
 		return;
 	}
 
@@ -50,17 +225,7 @@ void AThrowableActor::NotifyHit(UPrimitiveComponent* MyComp, AActor* Other, UPri
 	//// IF launched AND character hit is NOT the launcher
 	//// THEN do damage etc.
 	if (State == EState::Launch) {
-		IInteractInterface* InteractInterfaceObject = Cast<IInteractInterface>(Other);
-		if (InteractInterfaceObject) {
-			InteractInterfaceObject->Execute_ApplyEffect(Other, EffectType, false);
-		}
-
-		AActor* CurrentOwner = GetOwner();
-		if (CurrentOwner && CurrentOwner != Other) {
-			if (ATantrumnCharacterBase* TantrumnCharacterBase = Cast<ATantrumnCharacterBase>(Other)) {
-				TantrumnCharacterBase->NotifyHitByThrowable(this);
-			}
-		}
+		HandleLaunchHit(Other);
 	}
 	// ignore all other hits
 	// this will wait until projectile comes to natural stop before returning it to idle
@@ -71,13 +236,14 @@ void AThrowableActor::NotifyHit(UPrimitiveComponent* MyComp, AActor* Other, UPri
 				AttachToComponent(TantrumnCharacter->GetMesh(), FAttachmentTransformRules::SnapToTargetNotIncludingScale, TEXT("ObjectAttach"));
 				SetOwner(TantrumnCharacter);
 				ProjectileMovementComponent->Deactivate();
-				State = EState::Attached;
+				EndFixedStepFlight();
+				SetState(EState::Attached);
 				//set character state to attached
 				TantrumnCharacter->OnThrowableAttached(this);
 			}
 			else {
 				TantrumnCharacter->ResetThrowableObject();
-				State = EState::Dropped;
+				SetState(EState::Dropped);
 			}
 		}
 	}
@@ -88,15 +254,196 @@ void AThrowableActor::NotifyHit(UPrimitiveComponent* MyComp, AActor* Other, UPri
 
 void AThrowableActor::ProjectileStop(const FHitResult& ImpactResult) {
 	if (State == EState::Launch || State == EState::Dropped) {
-		State = EState::Idle;
+		SetState(EState::Idle);
 	}
 }
 
-// Called every frame
-//void AThrowableActor::Tick(float DeltaTime)
-//{
-//	Super::Tick(DeltaTime);
-//}
+void AThrowableActor::Tick(float DeltaTime) {
+	Super::Tick(DeltaTime);
+
+	if (bFixedStepFlight) {
+		AdvanceFixedStepFlight(DeltaTime, CVarMaxFlightSteps.GetValueOnGameThread());
+	}
+
+	if (State != EState::Launch || LaunchRewindTime <= 0.0f) {
+		UpdateTickEnabled();
+		return;
+	}
+
+	// the thrower saw the other characters LaunchRewindTime ago, test the path flown this frame against where they were then
+	const FVector CurrentLocation = GetActorLocation();
+	const float RewoundTime = GetWorld()->GetTimeSeconds() - LaunchRewindTime;
+	const float Radius = StaticMeshComponent->Bounds.SphereRadius;
+	for (TActorIterator<ATantrumnCharacterBase> It(GetWorld()); It; ++It) {
+		ATantrumnCharacterBase* TantrumnCharacter = *It;
+		if (TantrumnCharacter == GetOwner() || LaunchHitActors.Contains(TantrumnCharacter)) {
+			continue;
+		}
+
+		UTantrumnLagCompensationComponent* LagCompensation = TantrumnCharacter->GetLagCompensationComponent();
+		if (LagCompensation && LagCompensation->SegmentHitsCapsuleAtTime(LastLaunchLocation, CurrentLocation, Radius, RewoundTime)) {
+			HandleLaunchHit(TantrumnCharacter);
+		}
+	}
+	LastLaunchLocation = CurrentLocation;
+}
+
+void AThrowableActor::UpdateTickEnabled() {
+	SetActorTickEnabled(bFixedStepFlight || (State == EState::Launch && LaunchRewindTime > 0.0f));
+}
+
+bool AThrowableActor::IsFixedStepFlightEnabled() {
+	return CVarFixedStepFlight.GetValueOnGameThread() != 0;
+}
+
+bool AThrowableActor::HasHomingTarget() const {
+	return ProjectileMovementComponent->bIsHomingProjectile && ProjectileMovementComponent->HomingTargetComponent.IsValid();
+}
+
+float AThrowableActor::GetServerWorldTime() const {
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	return GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+}
+
+void AThrowableActor::BeginFixedStepFlight() {
+	FlightVelocity = ProjectileMovementComponent->Velocity;
+	ProjectileMovementComponent->Deactivate();
+	FlightTimeRemainder = 0.0f;
+	bFixedStepFlight = true;
+
+	// without a homing target the whole flight follows from where and how fast it started
+	if (HasAuthority() && !HasHomingTarget()) {
+		LaunchEvent.Location = GetActorLocation();
+		LaunchEvent.Velocity = FlightVelocity;
+		LaunchEvent.Thrower = State == EState::Launch ? GetOwner() : nullptr;
+		LaunchEvent.ServerTime = GetServerWorldTime();
+		MARK_PROPERTY_DIRTY_FROM_NAME(AThrowableActor, LaunchEvent, this);
+		SetReplicateMovement(false);
+	}
+	UpdateTickEnabled();
+}
+
+void AThrowableActor::EndFixedStepFlight() {
+	if (!bFixedStepFlight) {
+		return;
+	}
+	bFixedStepFlight = false;
+	FlightVelocity = FVector::ZeroVector;
+
+	if (HasAuthority()) {
+		// replicated movement takes back over and sends where the flight ended
+		SetReplicateMovement(true);
+	}
+	else if (LaunchEvent.Thrower) {
+		StaticMeshComponent->IgnoreActorWhenMoving(LaunchEvent.Thrower, false);
+	}
+	UpdateTickEnabled();
+}
+
+void AThrowableActor::AdvanceFixedStepFlight(float DeltaTime, int32 MaxSteps) {
+	const float StepTime = 1.0f / FMath::Max(CVarFixedStepRate.GetValueOnGameThread(), 1.0f);
+	FlightTimeRemainder += DeltaTime;
+
+	// steps over the per frame limit stay owed and are caught up on the next frames, so after a hitch
+	// every machine is still at the same step for the same time since launch
+	int32 NumSteps = 0;
+	while (bFixedStepFlight && FlightTimeRemainder >= StepTime && NumSteps < MaxSteps) {
+		FlightTimeRemainder -= StepTime;
+		StepFlight(StepTime);
+		++NumSteps;
+	}
+
+	// but no more than the catch up allowed for a late launch event, a long hitch drops the rest
+	FlightTimeRemainder = FMath::Min(FlightTimeRemainder, FMath::Max(CVarMaxFlightCatchUp.GetValueOnGameThread(), StepTime));
+}
+
+void AThrowableActor::StepFlight(float StepTime) {
+	TANTRUMN_SCOPE_CYCLE_COUNTER(STAT_TantrumnThrowableFlightStep);
+
+	// same integration as the projectile component, but every machine takes the same steps
+	FVector Acceleration(0.0f, 0.0f, ProjectileMovementComponent->GetGravityZ());
+	if (HasHomingTarget()) {
+		const FVector ToTarget = ProjectileMovementComponent->HomingTargetComponent->GetComponentLocation() - GetActorLocation();
+		Acceleration += ToTarget.GetSafeNormal() * ProjectileMovementComponent->HomingAccelerationMagnitude;
+	}
+
+	const FVector MoveDelta = FlightVelocity * StepTime + Acceleration * (0.5f * StepTime * StepTime);
+	FlightVelocity += Acceleration * StepTime;
+	const float MaxSpeed = ProjectileMovementComponent->GetMaxSpeed();
+	if (MaxSpeed > 0.0f) {
+		FlightVelocity = FlightVelocity.GetClampedToMaxSize(MaxSpeed);
+	}
+
+	FHitResult Hit;
+	SetActorLocation(GetActorLocation() + MoveDelta, true, &Hit);
+	if (ProjectileMovementComponent->bRotationFollowsVelocity && !FlightVelocity.IsNearlyZero()) {
+		SetActorRotation(FlightVelocity.Rotation());
+	}
+
+	// the sweep already went through NotifyHit, which may have attached or ended the flight
+	if (bFixedStepFlight && Hit.IsValidBlockingHit()) {
+		HandleFlightImpact(Hit);
+	}
+}
+
+void AThrowableActor::HandleFlightImpact(const FHitResult& Hit) {
+	if (ProjectileMovementComponent->bShouldBounce) {
+		// friction slows the part along the surface, bounciness scales the reflected part
+		const FVector NormalVelocity = Hit.Normal * (FlightVelocity | Hit.Normal);
+		const FVector TangentVelocity = FlightVelocity - NormalVelocity;
+		FlightVelocity = TangentVelocity * FMath::Clamp(1.0f - ProjectileMovementComponent->Friction, 0.0f, 1.0f) - NormalVelocity * FMath::Max(ProjectileMovementComponent->Bounciness, 0.0f);
+		if (FlightVelocity.SizeSquared() >= FMath::Square(ProjectileMovementComponent->BounceVelocityStopSimulatingThreshold)) {
+			return;
+		}
+	}
+
+	EndFixedStepFlight();
+	if (HasAuthority()) {
+		ProjectileStop(Hit);
+	}
+}
+
+void AThrowableActor::OnRep_LaunchEvent() {
+	const float Elapsed = FMath::Max(GetServerWorldTime() - LaunchEvent.ServerTime, 0.0f);
+	// arriving long after the throw, e.g. on becoming relevant, the flight is over and replicated movement has the result
+	if (Elapsed > CVarMaxFlightCatchUp.GetValueOnGameThread()) {
+		return;
+	}
+
+	EndFixedStepFlight();
+	// movement replication is off for the flight, so the detach it would have carried happens here
+	DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+	SetActorLocation(LaunchEvent.Location, false, nullptr, ETeleportType::TeleportPhysics);
+	if (LaunchEvent.Thrower) {
+		StaticMeshComponent->IgnoreActorWhenMoving(LaunchEvent.Thrower, true);
+	}
+
+	ProjectileMovementComponent->HomingTargetComponent = nullptr;
+	ProjectileMovementComponent->Velocity = LaunchEvent.Velocity;
+	BeginFixedStepFlight();
+	// step through the time spent on the wire so this machine is on the server's step of the same path
+	AdvanceFixedStepFlight(Elapsed, MAX_int32);
+}
+
+void AThrowableActor::HandleLaunchHit(AActor* Other) {
+	// a target can be hit once per throw, either by the rewound check or by the real collision
+	if (!Other || LaunchHitActors.Contains(Other)) {
+		return;
+	}
+	LaunchHitActors.Add(Other);
+
+	IInteractInterface* InteractInterfaceObject = Cast<IInteractInterface>(Other);
+	if (InteractInterfaceObject) {
+		InteractInterfaceObject->Execute_ApplyEffect(Other, EffectType, false);
+	}
+
+	AActor* CurrentOwner = GetOwner();
+	if (CurrentOwner && CurrentOwner != Other) {
+		if (ATantrumnCharacterBase* TantrumnCharacterBase = Cast<ATantrumnCharacterBase>(Other)) {
+			TantrumnCharacterBase->NotifyHitByThrowable(this);
+		}
+	}
+}
 
 bool AThrowableActor::Pull(AActor* InActor) {
 	if (State != EState::Idle) {
@@ -105,8 +452,11 @@ bool AThrowableActor::Pull(AActor* InActor) {
 
 	if (SetHomingTarget(InActor)) {
 		ToggleHighlight(false);
-		State = EState::Pull;
+		SetState(EState::Pull);
 		PullActor = InActor;
+		if (IsFixedStepFlightEnabled()) {
+			BeginFixedStepFlight();
+		}
 		return true;
 	}
 
@@ -120,16 +470,29 @@ void AThrowableActor::Launch(const FVector& InitialVelocity, AActor* Target /* =
 		ProjectileMovementComponent->Activate(true);
 		ProjectileMovementComponent->HomingTargetComponent = nullptr;
 
-		State = EState::Launch;
+		SetState(EState::Launch);
 
-		if (Target) {
-			if (USceneComponent* SceneComponent = Cast<USceneComponent>(Target->GetComponentByClass(USceneComponent::StaticClass()))) {
-				ProjectileMovementComponent->HomingTargetComponent = TWeakObjectPtr<USceneComponent>(SceneComponent);
-				return;
-			}
+		LaunchHitActors.Reset();
+		if (HasAuthority()) {
+			const ATantrumnCharacterBase* Thrower = Cast<ATantrumnCharacterBase>(GetOwner());
+			LaunchRewindTime = Thrower ? Thrower->GetViewRewindTime() : 0.0f;
+			LastLaunchLocation = GetActorLocation();
+			UpdateTickEnabled();
+		}
+
+		USceneComponent* TargetComponent = Target ? Cast<USceneComponent>(Target->GetComponentByClass(USceneComponent::StaticClass())) : nullptr;
+		if (TargetComponent) {
+			ProjectileMovementComponent->HomingTargetComponent = TWeakObjectPtr<USceneComponent>(TargetComponent);
+		}
+
+		// a fixed-step homing throw steers from the launch velocity, never from what the pull left behind
+		if (!TargetComponent || IsFixedStepFlightEnabled()) {
+			ProjectileMovementComponent->Velocity = InitialVelocity;
 		}
 
-		ProjectileMovementComponent->Velocity = InitialVelocity;
+		if (IsFixedStepFlightEnabled()) {
+			BeginFixedStepFlight();
+		}
 	}
 }
 
@@ -142,7 +505,10 @@ void AThrowableActor::Drop() {
 		ProjectileMovementComponent->Activate(true);
 		ProjectileMovementComponent->HomingTargetComponent = nullptr;
 
-		State = EState::Dropped;
+		SetState(EState::Dropped);
+		if (IsFixedStepFlightEnabled()) {
+			BeginFixedStepFlight();
+		}
 	}
 }
 
@@ -150,6 +516,83 @@ void AThrowableActor::ToggleHighlight(bool bIsOn) {
 	StaticMeshComponent->SetRenderCustomDepth(bIsOn);
 }
 
+void AThrowableActor::StopInteraction() {
+	DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+	ProjectileMovementComponent->StopMovementImmediately();
+	ProjectileMovementComponent->HomingTargetComponent = nullptr;
+	ProjectileMovementComponent->Deactivate();
+	PullActor = nullptr;
+	SetOwner(nullptr);
+	ToggleHighlight(false);
+	LaunchHitActors.Reset();
+	EndFixedStepFlight();
+	SetActorTickEnabled(false);
+}
+
+void AThrowableActor::SetPooled(bool bInPooled, const FTransform* InTransform /* = nullptr */) {
+	if (bInPooled) {
+		StopInteraction();
+		SetActorEnableCollision(false);
+		SetActorHiddenInGame(true);
+		bIsFromPool = true;
+		SetState(EState::Pooled);
+	}
+	else {
+		if (InTransform) {
+			SetActorTransform(*InTransform, false, nullptr, ETeleportType::ResetPhysics);
+		}
+		SetActorHiddenInGame(false);
+		SetActorEnableCollision(true);
+		SetState(EState::Idle);
+	}
+}
+
+void AThrowableActor::OnRep_Pooled() {
+	if (bPooled) {
+		EndFixedStepFlight();
+		ProjectileMovementComponent->Deactivate();
+		ToggleHighlight(false);
+	}
+	SetActorEnableCollision(!bPooled);
+	SetActorHiddenInGame(bPooled);
+
+	// clients keep their own idle index for pickup traces, pooled instances must not be found
+	if (UTantrumnThrowableSubsystem* ThrowableSubsystem = GetWorld()->GetSubsystem<UTantrumnThrowableSubsystem>()) {
+		if (bPooled) {
+			ThrowableSubsystem->UnregisterIdleThrowable(this);
+		}
+		else if (IsIdle()) {
+			ThrowableSubsystem->RegisterIdleThrowable(this);
+		}
+	}
+}
+
+void AThrowableActor::Reset() {
+	Super::Reset();
+	if (bIsFromPool && !IsPooled()) {
+		if (UTantrumnThrowablePoolSubsystem* PoolSubsystem = GetWorld()->GetSubsystem<UTantrumnThrowablePoolSubsystem>()) {
+			PoolSubsystem->ReleaseThrowable(this);
+		}
+	}
+}
+
+void AThrowableActor::ResetToIdle(const FTransform& InTransform) {
+	const bool bWasIdle = IsIdle();
+	StopInteraction();
+	SetActorTransform(InTransform, false, nullptr, ETeleportType::ResetPhysics);
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	SetState(EState::Idle);
+
+	// already idle means already dormant, push the new transform and move it in the index
+	if (bWasIdle) {
+		FlushNetDormancy();
+		if (UTantrumnThrowableSubsystem* ThrowableSubsystem = GetWorld()->GetSubsystem<UTantrumnThrowableSubsystem>()) {
+			ThrowableSubsystem->UpdateIdleThrowable(this);
+		}
+	}
+}
+
 EEffectType AThrowableActor::GetEffectType() {
 	return EffectType;
 }
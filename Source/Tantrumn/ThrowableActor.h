@@ -10,6 +10,26 @@
 class UStaticMeshComponent;
 class UProjectileMovementComponent;
 
+// start of a flight every machine simulates itself, sent instead of movement while it flies
+USTRUCT()
+struct FThrowableLaunchEvent {
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FVector Location = FVector::ZeroVector;
+
+	UPROPERTY()
+	FVector Velocity = FVector::ZeroVector;
+
+	// ignored by the flight on every machine, as the server ignores it while throwing
+	UPROPERTY()
+	AActor* Thrower = nullptr;
+
+	// server world time the flight started, receivers step through the time they missed
+	UPROPERTY()
+	float ServerTime = 0.0f;
+};
+
 UCLASS()
 class TANTRUMN_API AThrowableActor : public AActor
 {
@@ -19,6 +39,10 @@ public:
 	// Sets default values for this actor's properties
 	AThrowableActor();
 
+	virtual void Tick(float DeltaTime) override;
+
+	void GetLifetimeReplicatedProps(TArray< FLifetimeProperty >& OutLifetimeProps) const override;
+
 	UFUNCTION(BlueprintCallable)
 	bool IsIdle() const { return State == EState::Idle; }
 
@@ -36,6 +60,17 @@ public:
 
 	EEffectType GetEffectType();
 
+	bool IsPooled() const { return State == EState::Pooled; }
+
+	// only called by UTantrumnThrowablePoolSubsystem, resets and hides the actor or places it back in the world
+	void SetPooled(bool bInPooled, const FTransform* InTransform = nullptr);
+
+	// returns instances taken from the pool to it instead of leaving them in the level
+	virtual void Reset() override;
+
+	// server only, puts the throwable back to rest at InTransform, used when a match restarts
+	void ResetToIdle(const FTransform& InTransform);
+
 protected:
 	enum class EState {
 		Idle,
@@ -43,16 +78,21 @@ protected:
 		Attached,
 		Launch,
 		Dropped,
+		Pooled,
 	};
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void OnRep_ReplicatedMovement() override;
 
 	virtual void NotifyHit(class UPrimitiveComponent* MyComp, AActor* Other, class UPrimitiveComponent* OtherComp, bool bSelfMoved, FVector HitLocation, FVector HitNormal, FVector NormalImpulse, const FHitResult& Hit) override;
 
 	UFUNCTION()
 	void ProjectileStop(const FHitResult& ImpactResult);
 
+	// applies the effect and stun of a launched throwable to whatever it hit
+	void HandleLaunchHit(AActor* Other);
+
 	UFUNCTION(BlueprintCallable)
 	bool SetHomingTarget(AActor* Target);
 
@@ -61,11 +101,69 @@ protected:
 	UPROPERTY(EditAnywhere)
 	UProjectileMovementComponent* ProjectileMovementComponent;
 
+	// stops any pull or throw in progress and detaches from whoever was holding it
+	void StopInteraction();
+
+	// all state changes go through here so the idle throwable index stays in sync
+	void SetState(EState InState);
+
+	// keeps the live throwables per state counters in stat Tantrumn current
+	static void UpdateStateStat(EState InState, bool bAdd);
+
+	// pull, launch and dropped always end on their own, holding one too long is reported as stuck
+	void OnStateStuck();
+	FTimerHandle StuckStateTimerHandle;
+
+	// fixed step flight replaces the projectile component's movement when Tantrumn.Throw.FixedStepFlight is set,
+	// the component still holds the tuning and the starting velocity
+	static bool IsFixedStepFlightEnabled();
+	void BeginFixedStepFlight();
+	void EndFixedStepFlight();
+	// only whole steps are simulated, the remainder carries over to the next call
+	void AdvanceFixedStepFlight(float DeltaTime, int32 MaxSteps);
+	void StepFlight(float StepTime);
+	void HandleFlightImpact(const FHitResult& Hit);
+	bool HasHomingTarget() const;
+
+	bool bFixedStepFlight = false;
+	FVector FlightVelocity = FVector::ZeroVector;
+	float FlightTimeRemainder = 0.0f;
+
+	UPROPERTY(ReplicatedUsing = OnRep_LaunchEvent)
+	FThrowableLaunchEvent LaunchEvent;
+
+	UFUNCTION()
+	void OnRep_LaunchEvent();
+
+	float GetServerWorldTime() const;
+
+	// ticks while flying with fixed steps or checking a launch against rewound characters
+	void UpdateTickEnabled();
+
+	bool ShouldBeDormant() const { return State == EState::Idle || State == EState::Pooled; }
+
 	EState State = EState::Idle;
 
+	// set once the actor has been managed by the pool, placed throwables are not returned on Reset
+	bool bIsFromPool = false;
+
+	// State is server only, clients need this to stop colliding with and tracing for hidden pooled instances
+	UPROPERTY(ReplicatedUsing = OnRep_Pooled)
+	bool bPooled = false;
+
+	UFUNCTION()
+	void OnRep_Pooled();
+
 	UPROPERTY()
 	AActor* PullActor = nullptr;
 
+	// lag compensation for the current throw, only used on the server
+	float LaunchRewindTime = 0.0f;
+	FVector LastLaunchLocation = FVector::ZeroVector;
+
+	UPROPERTY()
+	TArray<AActor*> LaunchHitActors;
+
 	UPROPERTY(EditAnywhere)
 	FVector PullVelocity = FVector(0.0f, 0.0f, 1000.0f);
 
@@ -0,0 +1,23 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+using System.Collections.Generic;
+
+public class TantrumnServerTarget : TargetRules
+{
+	public TantrumnServerTarget( TargetInfo Target) : base(Target)
+	{
+		Type = TargetType.Server;
+		DefaultBuildSettings = BuildSettingsVersion.V2;
+		ExtraModuleNames.AddRange( new string[] { "Tantrumn" } );
+
+		// server targets already need a source engine, so build it in its own environment
+		BuildEnvironment = TargetBuildEnvironment.Unique;
+
+		// compiles in push model support, enabled at runtime with net.IsPushModelEnabled
+		bWithPushModel = true;
+
+		// keep logs in shipping server builds, they are the only output a headless server has
+		bUseLoggingInShipping = true;
+	}
+}